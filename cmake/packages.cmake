@@ -1,9 +1,12 @@
 
 function(find_packages)
-  message("checking compiler installed...")
-  find_program(CMAKE_C_COMPILER NAMES x86_64-w64-mingw32-gcc REQUIRED)
-  find_program(CMAKE_CXX_COMPILER NAMES x86_64-w64-mingw32-g++ REQUIRED)
-  find_program(CMAKE_RC_COMPILER NAMES x86_64-w64-mingw32-windres windres REQUIRED)
+  # the windows toolchain. other hosts only build the tests and benches
+  if(CMAKE_HOST_WIN32)
+    message("checking compiler installed...")
+    find_program(CMAKE_C_COMPILER NAMES x86_64-w64-mingw32-gcc REQUIRED)
+    find_program(CMAKE_CXX_COMPILER NAMES x86_64-w64-mingw32-g++ REQUIRED)
+    find_program(CMAKE_RC_COMPILER NAMES x86_64-w64-mingw32-windres windres REQUIRED)
+  endif()
 
   message("finding packages...")
 
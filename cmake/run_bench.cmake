@@ -0,0 +1,39 @@
+# Runs game_bench and saves the results as json, named after the current commit.
+#
+# cmake -DBENCH_EXE=<path> -DOUT_DIR=<dir> -DSOURCE_DIR=<repo> -P run_bench.cmake
+#
+# Compare two runs with google benchmark's compare.py:
+# compare.py benchmarks game_bench_<old>.json game_bench_<new>.json
+
+if(NOT BENCH_EXE OR NOT OUT_DIR)
+  message(FATAL_ERROR "run_bench.cmake: BENCH_EXE and OUT_DIR are required")
+endif()
+
+set(COMMIT "nogit")
+find_package(Git QUIET)
+if(GIT_FOUND)
+  execute_process(
+    COMMAND ${GIT_EXECUTABLE} rev-parse --short HEAD
+    WORKING_DIRECTORY ${SOURCE_DIR}
+    OUTPUT_VARIABLE GIT_COMMIT
+    OUTPUT_STRIP_TRAILING_WHITESPACE
+    RESULT_VARIABLE GIT_RESULT
+    ERROR_QUIET
+  )
+  if(GIT_RESULT EQUAL 0)
+    set(COMMIT ${GIT_COMMIT})
+  endif()
+endif()
+
+file(MAKE_DIRECTORY ${OUT_DIR})
+set(OUT_FILE ${OUT_DIR}/game_bench_${COMMIT}.json)
+
+execute_process(
+  COMMAND ${BENCH_EXE} --benchmark_out=${OUT_FILE} --benchmark_out_format=json
+  RESULT_VARIABLE BENCH_RESULT
+)
+if(NOT BENCH_RESULT EQUAL 0)
+  message(FATAL_ERROR "game_bench failed: ${BENCH_RESULT}")
+endif()
+
+message("wrote ${OUT_FILE}")
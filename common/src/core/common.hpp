@@ -1,14 +1,23 @@
 #pragma once
 
+#include "core/latency/input_latency.hpp"
+#include "core/log/log.hpp"
 #include "core/maths/vec.hpp"
+#include "core/memory/frame_arena.hpp"
+#include "core/memory/tracked_allocator.hpp"
+#include "core/registry.hpp"
 
 #include <SDL3/SDL.h>
 #include <box2d/box2d.h>
 #include <entt/entt.hpp>
 #include <imgui.h>
 
+#include <array>
+#include <memory>
 #include <mutex>
 #include <random>
+#include <span>
+#include <vector>
 
 namespace game2d {
 
@@ -52,10 +61,38 @@ struct Renderable
   ColourComponent colour;
 };
 
+// layout must match SpriteData in PullSpriteBatch.vert.hlsl
+typedef struct SpriteInstance
+{
+  float x, y, z;
+  float rotation;
+  float w, h, p1, p2;
+  float tex_u, tex_v, tex_w, tex_h;
+  float colour[4];
+} SpriteInstance;
+
+struct ParticleBuffer;
+struct PhysicsPipeline;
+struct EventBus;
+
+// Runs fn over [0, n) split in to ranges, on the engine's worker threads.
+// Same shape as box2d's enqueueTask/finishTask. The function pointers
+// are engine code, so the job system state stays in the exe across reloads.
+typedef void job_range_func_t(uint32_t start, uint32_t end, uint32_t thread, void* user);
+struct JobSystem
+{
+  void* (*enqueue)(job_range_func_t* fn, uint32_t n, uint32_t min_range, void* user, void* ctx) = nullptr;
+  void (*finish)(void* job, void* ctx) = nullptr;
+  void* ctx = nullptr;
+};
+
+// Items live in the InventoryPool (game/src/core/inventory),
+// in the slots [offset, offset + capacity). [offset, offset + count) are full.
 struct InventoryComponent
 {
-  // std::vector<entt::entity> items;
-  int items = 0;
+  uint32_t offset = 0;
+  uint16_t capacity = 0;
+  uint16_t count = 0;
 };
 
 // not sure about "UIEntity"
@@ -68,6 +105,62 @@ struct UIEntity
   InventoryComponent inventory;
 };
 
+// published by the gamethread when an entry changes.
+// the vector is never written once shared, so copying
+// CommonUiData between threads only copies the pointer.
+struct UiModel
+{
+  std::shared_ptr<const std::vector<UIEntity>> entities;
+  uint64_t version = 0;
+};
+
+// set by the engine. the snapshot's deleter has to live in the exe,
+// because the engine's copies outlive the dll that published them.
+using make_ui_snapshot_func_t = std::shared_ptr<const std::vector<UIEntity>> (*)(std::span<const UIEntity> entries);
+
+constexpr int N_TICK_HISTOGRAM_BUCKETS = 16;
+
+// fixed step telemetry, written by the engine
+struct FixedStepStats
+{
+  float tick_hz = 60.0f;
+  int max_steps_per_frame = 4;
+  int steps_last_frame = 0;
+  float time_dilation = 1.0f; // game seconds per wall second, < 1 when dropping ticks
+  uint64_t n_ticks = 0;
+  uint64_t n_over_budget = 0; // ticks that took longer than the time they simulate
+  uint64_t n_dropped = 0;     // ticks skipped to stay within max_steps_per_frame
+
+  // bucket 0 counts ticks under 1us, bucket i counts [2^(i-1), 2^i) us
+  std::array<uint32_t, N_TICK_HISTOGRAM_BUCKETS> histogram{};
+};
+
+// one system from the gamethread's schedule, for the debug ui
+struct SystemTimingUi
+{
+  char name[32] = {};
+  int batch = 0;
+  float ms = 0.0f;
+  bool critical = false;
+  bool main_thread = false;
+};
+
+struct EventCounts
+{
+  uint32_t published = 0;
+  uint32_t consumed = 0;
+  uint32_t dropped = 0;
+};
+
+// one event type on the bus, for the debug ui
+struct EventStatsUi
+{
+  char name[32] = {};
+  EventCounts counts; // last frame
+  uint32_t pending = 0;
+  uint32_t capacity = 0;
+};
+
 struct CommonUiData
 {
   // data to show in UI
@@ -81,8 +174,27 @@ struct CommonUiData
 
   int n_contact_events = 0;
   int n_sensor_events = 0;
+  int n_active_bodies = 0;
+  int n_inactive_bodies = 0;
+  int n_flow_agents = 0;
+  uint32_t flow_rebuilds = 0;
+  uint32_t flow_incremental = 0;
+  uint32_t flow_last_touched = 0; // tiles recomputed by the last update
+  bool physics_pipelined = false;
+  FixedStepStats fixed_step;
+
+  std::vector<SystemTimingUi> schedule;
+  float schedule_critical_ms = 0.0f;
+  float schedule_total_ms = 0.0f;
+
+  UiModel ui_model;
+  std::vector<EventStatsUi> events; // written by the engine
 
-  std::vector<UIEntity> hmm;
+  // per-thread frame arenas, written by the engine
+  FrameArenaStats game_arena;
+  FrameArenaStats render_arena;
+  MemoryStats memory;              // written by the engine
+  InputLatencyStats input_latency; // written by the renderthread
 
   // set to true/false by game thread
   bool game_over = false;
@@ -90,17 +202,33 @@ struct CommonUiData
   // set to true by ui thread, set to false by game thread.
   bool play_again = false;
 
+  // set by ui thread, set to 0 by game thread once applied.
+  float requested_tick_hz = 0.0f;
+
   // std::vector<std::pair<std::string, std::string>> something;
 };
 
 // data owned by the GameThread
 struct GameData
 {
-  entt::registry* r = nullptr;
+  Registry* r = nullptr;
   float dt = 0.0f;
+  float fixed_dt = 1.0f / 60.0f; // set by the engine each tick
+  int seed = 0; // set by the engine, recorded in replays
+  bool replaying = false; // set by the engine. SDL is not initialised
   b2WorldId world_id;
+  ParticleBuffer* particles = nullptr;
+  PhysicsPipeline* physics = nullptr;    // owned by the engine
+  JobSystem* jobs = nullptr;             // owned by the engine
+  EventBus* bus = nullptr;               // owned by the engine
+  FrameArena* frame_arena = nullptr;     // gamethread only, reset each tick
+  MemoryTracker* memory = nullptr;       // owned by the engine
+  Logger* logger = nullptr;              // owned by the engine
+
+  make_ui_snapshot_func_t make_ui_snapshot = nullptr; // set by the engine
 
   vec2 camera_pos{ 0, 0 };
+  vec2 camera_velocity{ 0, 0 }; // pixels per second, from this update's input
   vec2 mouse_pos{ 0, 0 };
   std::vector<SDL_Event> events;
 
@@ -117,7 +245,11 @@ struct RenderData
 
   // data
   std::vector<Renderable> renderable;
+  std::vector<SpriteInstance> particles;
   vec2 camera_pos{ 0, 0 };
+  vec2 camera_velocity{ 0, 0 };
+  uint64_t camera_ns = 0;     // when the gamethread wrote the camera
+  InputLatencySample latency; // cleared once the renderthread takes it
   CommonUiData ui_data;
 };
 
@@ -125,10 +257,17 @@ struct RenderData
 struct GameUIData
 {
   ImGuiContext* ctx;
+  FrameArena* frame_arena = nullptr; // renderthread only, reset each frame
+  MemoryTracker* memory = nullptr;   // owned by the engine
 
   std::vector<Renderable> renderable;
+  int n_particles = 0; // the particles go straight from RenderData to the gpu
   vec2 camera_pos{ 0, 0 };
   CommonUiData ui_data;
+
+  // move the camera on by the time since the gamethread sampled its input,
+  // just before the sprites are packed. set by the ui, or --late-camera
+  bool late_camera = false;
 };
 
 } // namespace game2d
\ No newline at end of file
@@ -0,0 +1,110 @@
+#include "core/pch.hpp"
+
+#include "event_bus.hpp"
+
+#include <bit>
+
+namespace game2d {
+
+void
+init_event_bus(EventBus& bus, const size_t storage_bytes)
+{
+  bus.rings = {};
+  bus.n_types = 0;
+  init_frame_arena(bus.storage, storage_bytes);
+};
+
+uint32_t
+register_event_type(EventBus& bus, const char* name, const uint32_t elem_size, const uint32_t elem_align, uint32_t capacity)
+{
+  capacity = std::bit_ceil(std::max(capacity, 1u));
+
+  uint32_t type = INVALID_EVENT_TYPE;
+  for (uint32_t i = 0; i < bus.n_types; i++) {
+    if (SDL_strcmp(bus.rings[i].name, name) == 0)
+      type = i;
+  }
+
+  // already registered, e.g. before a dll reload
+  if (type != INVALID_EVENT_TYPE) {
+    const EventRing& ring = bus.rings[type];
+    if (ring.elem_size == elem_size && ring.capacity == capacity)
+      return type;
+    SDL_Log("(EventBus) %s changed layout, pending events dropped", name);
+  } else {
+    if (bus.n_types == MAX_EVENT_TYPES) {
+      SDL_Log("(EventBus) no room for event type %s", name);
+      return INVALID_EVENT_TYPE;
+    }
+    type = bus.n_types++;
+  }
+
+  // storage is never given back, a changed type gets new storage
+  auto* data = static_cast<std::byte*>(arena_alloc(bus.storage, (size_t)elem_size * capacity, elem_align));
+  if (data == nullptr) {
+    SDL_Log("(EventBus) no storage left for event type %s", name);
+    return INVALID_EVENT_TYPE;
+  }
+
+  EventRing& ring = bus.rings[type];
+  ring = EventRing{};
+  SDL_strlcpy(ring.name, name, sizeof(ring.name));
+  ring.elem_size = elem_size;
+  ring.capacity = capacity;
+  ring.data = data;
+  return type;
+};
+
+bool
+publish_event(EventBus& bus, const uint32_t type, const void* evt)
+{
+  if (type >= bus.n_types)
+    return false;
+  EventRing& ring = bus.rings[type];
+
+  if (ring.head - ring.tail == ring.capacity) {
+    ring.frame.dropped++;
+    return false;
+  }
+
+  const uint64_t index = ring.head & (ring.capacity - 1);
+  SDL_memcpy(ring.data + index * ring.elem_size, evt, ring.elem_size);
+  ring.head++;
+  ring.frame.published++;
+  return true;
+};
+
+void
+clear_events(EventBus& bus, const uint32_t type)
+{
+  if (type >= bus.n_types)
+    return;
+  EventRing& ring = bus.rings[type];
+  ring.tail = ring.head;
+};
+
+void
+begin_event_frame(EventBus& bus)
+{
+  for (uint32_t i = 0; i < bus.n_types; i++) {
+    EventRing& ring = bus.rings[i];
+    ring.last_frame = ring.frame;
+    ring.frame = {};
+  }
+};
+
+void
+export_event_stats(const EventBus& bus, std::vector<EventStatsUi>& out)
+{
+  out.resize(bus.n_types);
+  for (uint32_t i = 0; i < bus.n_types; i++) {
+    const EventRing& ring = bus.rings[i];
+    EventStatsUi& row = out[i];
+    SDL_strlcpy(row.name, ring.name, sizeof(row.name));
+    row.counts = ring.last_frame;
+    row.pending = (uint32_t)(ring.head - ring.tail);
+    row.capacity = ring.capacity;
+  }
+};
+
+} // namespace game2d
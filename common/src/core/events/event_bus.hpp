@@ -0,0 +1,126 @@
+#pragma once
+
+#include "core/common.hpp"
+#include "core/memory/frame_arena.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+//
+// Events between gamethread systems.
+// Each event type has a fixed capacity ring of POD events.
+// Events are fixed size and copied in to the ring, with no payload storage.
+// Anything an event points to has to outlive it.
+// Publishing to a full ring drops the event, and counts it.
+// Events stay in the ring until a system consumes them.
+//
+// The bus is owned by the engine, so pending events survive a dll reload.
+// Only the gamethread publishes and consumes.
+//
+
+namespace game2d {
+
+constexpr uint32_t MAX_EVENT_TYPES = 32;
+constexpr uint32_t INVALID_EVENT_TYPE = UINT32_MAX;
+
+struct EventRing
+{
+  char name[32] = {};
+  uint32_t elem_size = 0;
+  uint32_t capacity = 0; // power of two
+  std::byte* data = nullptr;
+
+  // monotonic, wrapped by capacity when indexing
+  uint64_t head = 0; // next write
+  uint64_t tail = 0; // next read
+
+  EventCounts frame;      // this frame so far
+  EventCounts last_frame; // the whole of the last frame
+};
+
+struct EventBus
+{
+  std::array<EventRing, MAX_EVENT_TYPES> rings;
+  uint32_t n_types = 0;
+
+  // ring storage, carved out once when a type is registered. never reset
+  FrameArena storage;
+};
+
+void
+init_event_bus(EventBus& bus, const size_t storage_bytes);
+
+// types are found by name, so registering again after a dll reload keeps the ring.
+// returns INVALID_EVENT_TYPE if there is no room.
+uint32_t
+register_event_type(EventBus& bus, const char* name, const uint32_t elem_size, const uint32_t elem_align, uint32_t capacity);
+
+bool
+publish_event(EventBus& bus, const uint32_t type, const void* evt);
+
+// drops everything pending for the type
+void
+clear_events(EventBus& bus, const uint32_t type);
+
+// called by the engine at the start of each gamethread tick,
+// after the frame arena is reset
+void
+begin_event_frame(EventBus& bus);
+
+void
+export_event_stats(const EventBus& bus, std::vector<EventStatsUi>& out);
+
+//
+// typed helpers, used by the game
+//
+
+// set by register_event<T>(), per module
+template<typename T>
+inline uint32_t event_type_id = INVALID_EVENT_TYPE;
+
+template<typename T>
+void
+register_event(EventBus& bus, const char* name, const uint32_t capacity)
+{
+  static_assert(std::is_trivially_copyable_v<T>, "events are copied in to rings as bytes");
+  event_type_id<T> = register_event_type(bus, name, (uint32_t)sizeof(T), (uint32_t)alignof(T), capacity);
+};
+
+template<typename T>
+bool
+publish(EventBus& bus, const T& evt)
+{
+  return publish_event(bus, event_type_id<T>, &evt);
+};
+
+template<typename T>
+void
+clear_events(EventBus& bus)
+{
+  clear_events(bus, event_type_id<T>);
+};
+
+// calls fn with every pending event, as at most two contiguous spans
+template<typename T, typename Fn>
+void
+consume(EventBus& bus, Fn&& fn)
+{
+  if (event_type_id<T> == INVALID_EVENT_TYPE)
+    return;
+  EventRing& ring = bus.rings[event_type_id<T>];
+  const auto* events = reinterpret_cast<const T*>(ring.data);
+
+  while (ring.tail != ring.head) {
+    const auto start = (uint32_t)(ring.tail & (ring.capacity - 1));
+    const auto n = (uint32_t)std::min<uint64_t>(ring.head - ring.tail, ring.capacity - start);
+    fn(std::span<const T>(events + start, n));
+    ring.tail += n;
+    ring.frame.consumed += n;
+  }
+};
+
+} // namespace game2d
@@ -0,0 +1,115 @@
+#include "core/pch.hpp"
+
+#include "mapped_file.hpp"
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace game2d {
+
+#if defined(_WIN32)
+
+bool
+map_file(MappedFile& file, const char* path)
+{
+  unmap_file(file);
+
+  const HANDLE handle = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+  if (handle == INVALID_HANDLE_VALUE) {
+    SDL_Log("map_file(): failed to open %s", path);
+    return false;
+  }
+
+  LARGE_INTEGER size;
+  if (!GetFileSizeEx(handle, &size) || size.QuadPart == 0) {
+    SDL_Log("map_file(): %s is empty", path);
+    CloseHandle(handle);
+    return false;
+  }
+
+  const HANDLE mapping = CreateFileMappingA(handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+  const void* view = mapping ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+  if (view == nullptr) {
+    SDL_Log("map_file(): failed to map %s", path);
+    if (mapping)
+      CloseHandle(mapping);
+    CloseHandle(handle);
+    return false;
+  }
+
+  file.file = handle;
+  file.mapping = mapping;
+  file.data = static_cast<const std::byte*>(view);
+  file.size = (size_t)size.QuadPart;
+  return true;
+};
+
+void
+unmap_file(MappedFile& file)
+{
+  if (file.data)
+    UnmapViewOfFile(file.data);
+  if (file.mapping)
+    CloseHandle(file.mapping);
+  if (file.file)
+    CloseHandle(file.file);
+  file = MappedFile{};
+};
+
+#else
+
+bool
+map_file(MappedFile& file, const char* path)
+{
+  unmap_file(file);
+
+  const int fd = open(path, O_RDONLY);
+  if (fd < 0) {
+    SDL_Log("map_file(): failed to open %s", path);
+    return false;
+  }
+
+  struct stat st;
+  if (fstat(fd, &st) != 0 || st.st_size == 0) {
+    SDL_Log("map_file(): %s is empty", path);
+    close(fd);
+    return false;
+  }
+
+  void* view = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  if (view == MAP_FAILED) {
+    SDL_Log("map_file(): failed to map %s", path);
+    close(fd);
+    return false;
+  }
+
+  // the whole file is read front to back
+  madvise(view, (size_t)st.st_size, MADV_SEQUENTIAL);
+
+  file.fd = fd;
+  file.data = static_cast<const std::byte*>(view);
+  file.size = (size_t)st.st_size;
+  return true;
+};
+
+void
+unmap_file(MappedFile& file)
+{
+  if (file.data)
+    munmap(const_cast<std::byte*>(file.data), file.size);
+  if (file.fd >= 0)
+    close(file.fd);
+  file = MappedFile{};
+};
+
+#endif
+
+} // namespace game2d
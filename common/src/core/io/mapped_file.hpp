@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+namespace game2d {
+
+// A read-only view of a whole file, mapped in to memory.
+// Pages are only read from disk when they are touched.
+struct MappedFile
+{
+  const std::byte* data = nullptr;
+  size_t size = 0;
+
+#if defined(_WIN32)
+  void* file = nullptr;
+  void* mapping = nullptr;
+#else
+  int fd = -1;
+#endif
+};
+
+// returns false (and logs) if the file could not be mapped
+bool
+map_file(MappedFile& file, const char* path);
+
+void
+unmap_file(MappedFile& file);
+
+inline std::span<const std::byte>
+mapped_bytes(const MappedFile& file)
+{
+  return { file.data, file.size };
+};
+
+} // namespace game2d
@@ -0,0 +1,96 @@
+#include "core/pch.hpp"
+
+#include "input_latency.hpp"
+
+#include <cmath>
+
+namespace game2d {
+
+const char*
+latency_stage_name(const LatencyStage stage)
+{
+  switch (stage) {
+    case LatencyStage::EVENT:
+      return "total";
+    case LatencyStage::POLL:
+      return "poll";
+    case LatencyStage::DEQUEUE:
+      return "dequeue";
+    case LatencyStage::SIMULATE:
+      return "simulate";
+    case LatencyStage::EXTRACT:
+      return "extract";
+    case LatencyStage::SUBMIT:
+      return "submit";
+    default:
+      return "unknown";
+  }
+};
+
+void
+merge_latency_samples(InputLatencySample& into, const InputLatencySample& from)
+{
+  if (!from.valid)
+    return;
+  if (!into.valid || from.ns[(size_t)LatencyStage::EVENT] < into.ns[(size_t)LatencyStage::EVENT])
+    into = from;
+};
+
+void
+record_latency_sample(InputLatencyTracker& tracker, const InputLatencySample& sample)
+{
+  // a stage out of order means a clock or bookkeeping problem, not a slow frame
+  for (size_t i = 1; i < LATENCY_STAGE_COUNT; i++)
+    if (sample.ns[i] < sample.ns[i - 1])
+      return;
+
+  tracker.samples[tracker.next] = sample;
+  tracker.next = (tracker.next + 1) % N_LATENCY_SAMPLES;
+  tracker.n_samples = std::min(tracker.n_samples + 1, (uint32_t)N_LATENCY_SAMPLES);
+  tracker.n_total++;
+  tracker.dirty = true;
+};
+
+const InputLatencyStats&
+get_input_latency_stats(InputLatencyTracker& tracker)
+{
+  if (!tracker.dirty)
+    return tracker.stats;
+  tracker.dirty = false;
+
+  std::array<float, N_LATENCY_SAMPLES> ms;
+  const std::span<float> window{ ms.data(), tracker.n_samples };
+  for (size_t stage = 0; stage < LATENCY_STAGE_COUNT; stage++) {
+    const size_t from = stage == 0 ? 0 : stage - 1;
+    const size_t to = stage == 0 ? LATENCY_STAGE_COUNT - 1 : stage;
+    for (uint32_t i = 0; i < tracker.n_samples; i++) {
+      const InputLatencySample& s = tracker.samples[i];
+      ms[i] = (float)(1e-6 * (double)(s.ns[to] - s.ns[from]));
+    }
+    tracker.stats.stages[stage] = compute_latency_percentiles(window);
+  }
+  tracker.stats.n_samples = tracker.n_samples;
+  tracker.stats.n_total = tracker.n_total;
+  return tracker.stats;
+};
+
+LatencyPercentiles
+compute_latency_percentiles(std::span<float> ms)
+{
+  LatencyPercentiles p;
+  if (ms.empty())
+    return p;
+
+  std::sort(ms.begin(), ms.end());
+  const auto rank = [&](const float pct) -> float {
+    const size_t i = (size_t)std::ceil(pct * (float)ms.size());
+    return ms[std::clamp<size_t>(i, 1, ms.size()) - 1];
+  };
+  p.p50_ms = rank(0.50f);
+  p.p95_ms = rank(0.95f);
+  p.p99_ms = rank(0.99f);
+  p.max_ms = ms.back();
+  return p;
+};
+
+} // namespace game2d
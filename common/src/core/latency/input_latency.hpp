@@ -0,0 +1,85 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <span>
+
+namespace game2d {
+
+// The stages an input goes through before it is on screen.
+// Each is a SDL_GetTicksNS() time, the same clock as SDL_Event timestamps.
+enum class LatencyStage : uint8_t
+{
+  EVENT,    // SDL timestamped the event
+  POLL,     // mainthread finished polling
+  DEQUEUE,  // gamethread took it from the event queue
+  SIMULATE, // gamethread finished the update that used it
+  EXTRACT,  // gamethread wrote the frame in to RenderData
+  SUBMIT,   // renderthread submitted the first frame that shows it
+  COUNT,
+};
+constexpr size_t LATENCY_STAGE_COUNT = (size_t)LatencyStage::COUNT;
+
+// one input's trip through the stages.
+// only the oldest input in each batch is followed.
+struct InputLatencySample
+{
+  std::array<uint64_t, LATENCY_STAGE_COUNT> ns{};
+  bool valid = false;
+};
+
+struct LatencyPercentiles
+{
+  float p50_ms = 0.0f;
+  float p95_ms = 0.0f;
+  float p99_ms = 0.0f;
+  float max_ms = 0.0f;
+};
+
+constexpr int N_LATENCY_SAMPLES = 256;
+
+// what the ui shows. stage i is the time from stage i-1 to i,
+// stage 0 is the whole trip, from the event to the submit.
+struct InputLatencyStats
+{
+  std::array<LatencyPercentiles, LATENCY_STAGE_COUNT> stages{};
+  uint32_t n_samples = 0; // in the window
+  uint64_t n_total = 0;
+};
+
+// The last N_LATENCY_SAMPLES complete samples. Owned by the renderthread.
+struct InputLatencyTracker
+{
+  std::array<InputLatencySample, N_LATENCY_SAMPLES> samples;
+  uint32_t next = 0;
+  uint32_t n_samples = 0;
+  uint64_t n_total = 0;
+  bool dirty = false; // stats are recomputed only when a sample was added
+  InputLatencyStats stats;
+};
+
+const char*
+latency_stage_name(const LatencyStage stage);
+
+inline void
+stamp_latency(InputLatencySample& sample, const LatencyStage stage, const uint64_t ns)
+{
+  sample.ns[(size_t)stage] = ns;
+};
+
+// of the two, keep the one with the older input.
+// used when a frame is overwritten before it was shown, so the next one shows both.
+void
+merge_latency_samples(InputLatencySample& into, const InputLatencySample& from);
+
+void
+record_latency_sample(InputLatencyTracker& tracker, const InputLatencySample& sample);
+
+const InputLatencyStats&
+get_input_latency_stats(InputLatencyTracker& tracker);
+
+// nearest rank, values are sorted in place
+LatencyPercentiles
+compute_latency_percentiles(std::span<float> ms);
+
+} // namespace game2d
@@ -0,0 +1,454 @@
+#include "core/pch.hpp"
+
+#include "core/log/log.hpp"
+
+namespace game2d {
+
+// the record's first 8 bytes say how long it is, so padding can be skipped.
+// padding is only those 8 bytes
+struct LogRecordHeader
+{
+  uint32_t size;   // including the header, a multiple of 8
+  uint32_t n_args; // LOG_PAD for padding
+  uint64_t ns;
+  const LogSite* site;
+};
+constexpr uint32_t LOG_PAD = 0xffffffffu;
+constexpr uint64_t LOG_RING_MASK = LOG_RING_BYTES - 1;
+static_assert((LOG_RING_BYTES & LOG_RING_MASK) == 0, "ring size must be a power of 2");
+static_assert(sizeof(LogRecordHeader) + MAX_LOG_ARGS * (sizeof(LogArg) + MAX_LOG_STRING) < LOG_RING_BYTES / 2);
+
+// per module, like the registry's memory tracker
+static std::atomic<Logger*> module_logger = nullptr;
+
+// per module too, so the dll claims again after a reload. it gets the same ring back
+static thread_local LogRing* thread_ring = nullptr;
+static thread_local Logger* thread_ring_logger = nullptr;
+
+static const char*
+log_level_name(const LogLevel level)
+{
+  switch (level) {
+    case LogLevel::TRACE:
+      return "trace";
+    case LogLevel::DEBUG:
+      return "debug";
+    case LogLevel::INFO:
+      return "info";
+    case LogLevel::WARN:
+      return "warn";
+    case LogLevel::ERR:
+      return "error";
+    default:
+      return "unknown";
+  }
+};
+
+static const char*
+log_category_name(const LogCategory category)
+{
+  switch (category) {
+    case LogCategory::GENERAL:
+      return "general";
+    case LogCategory::INPUT:
+      return "input";
+    case LogCategory::PHYSICS:
+      return "physics";
+    case LogCategory::COLLISION:
+      return "collision";
+    case LogCategory::GAMEPLAY:
+      return "gameplay";
+    case LogCategory::ASSETS:
+      return "assets";
+    default:
+      return "unknown";
+  }
+};
+
+static constexpr uint32_t
+align8(const size_t n)
+{
+  return (uint32_t)((n + 7) & ~size_t(7));
+};
+
+// the ring the calling thread writes to, or nullptr if they are all taken
+static LogRing*
+claim_log_ring(Logger& logger)
+{
+  if (thread_ring_logger == &logger)
+    return thread_ring;
+
+  std::scoped_lock<std::mutex> lock(logger.claim_mtx);
+  const SDL_ThreadID id = SDL_GetCurrentThreadID();
+  LogRing* ring = nullptr;
+  for (LogRing& r : logger.rings) {
+    if (r.owner.load(std::memory_order_relaxed) == id) {
+      ring = &r;
+      break;
+    }
+  }
+  for (int i = 0; ring == nullptr && i < MAX_LOG_RINGS; i++) {
+    if (logger.rings[i].owner.load(std::memory_order_relaxed) == 0) {
+      ring = &logger.rings[i];
+      ring->owner.store(id, std::memory_order_relaxed);
+    }
+  }
+
+  thread_ring = ring;
+  thread_ring_logger = &logger;
+  return ring;
+};
+
+static void
+append_log_prefix(std::string& out, const LogSite* site, const uint64_t ns)
+{
+  char prefix[64];
+  const int n = SDL_snprintf(prefix,
+                             sizeof(prefix),
+                             "[%0.3f][%s][%s] ",
+                             1e-9 * (double)ns,
+                             log_level_name(site->level),
+                             log_category_name(site->category));
+  out.append(prefix, (size_t)std::max(n, 0));
+};
+
+// formats one record. returns its size
+static uint32_t
+write_log_record(std::string& line, const std::byte* record)
+{
+  // padding can be as short as its 8 bytes, at the very end of the buffer.
+  // read the size first, the full header only once it is known to be a record
+  uint32_t size_and_n_args[2];
+  std::memcpy(size_and_n_args, record, sizeof(size_and_n_args));
+  if (size_and_n_args[1] == LOG_PAD)
+    return size_and_n_args[0];
+
+  LogRecordHeader header;
+  std::memcpy(&header, record, sizeof(header));
+
+  LogArg args[MAX_LOG_ARGS];
+  std::memcpy(args, record + sizeof(header), header.n_args * sizeof(LogArg));
+
+  // strings follow the args. point them at the copies
+  const std::byte* strings = record + sizeof(header) + header.n_args * sizeof(LogArg);
+  for (uint32_t i = 0; i < header.n_args; i++) {
+    if (args[i].type != LogArgType::STR)
+      continue;
+    args[i].p = strings;
+    strings += args[i].len;
+  }
+
+  line.clear();
+  append_log_prefix(line, header.site, header.ns);
+  format_log_args(line, header.site->fmt, args, (int)header.n_args);
+  SDL_Log("%s", line.c_str());
+  return header.size;
+};
+
+// the consumer side. caller holds drain_mtx
+static void
+drain_log_rings(Logger& logger)
+{
+  for (LogRing& ring : logger.rings) {
+    uint64_t r = ring.read.load(std::memory_order_relaxed);
+    const uint64_t w = ring.write.load(std::memory_order_acquire);
+    while (r < w)
+      r += write_log_record(logger.line, ring.buffer.get() + (r & LOG_RING_MASK));
+    ring.read.store(r, std::memory_order_release);
+
+    const uint64_t n_dropped = ring.n_dropped.load(std::memory_order_relaxed);
+    if (n_dropped != ring.n_dropped_reported) {
+      SDL_Log("(Log) ring full, %llu records dropped", (unsigned long long)(n_dropped - ring.n_dropped_reported));
+      ring.n_dropped_reported = n_dropped;
+    }
+  }
+};
+
+static void
+log_worker(Logger* logger)
+{
+  tracy::SetThreadName("LogThread");
+
+  // records are picked up every few ms. producers never wake the thread,
+  // so logging stays a copy in to the ring
+  std::unique_lock<std::mutex> lock(logger->mtx);
+  while (true) {
+    logger->cv.wait_for(lock, std::chrono::milliseconds(2));
+    const bool quit = logger->quit;
+    lock.unlock();
+    {
+      std::scoped_lock<std::mutex> drain_lock(logger->drain_mtx);
+      drain_log_rings(*logger);
+    }
+    logger->cv.notify_all();
+    lock.lock();
+    if (quit)
+      return;
+  }
+};
+
+void
+init_logger(Logger& logger)
+{
+  for (LogRing& ring : logger.rings) {
+    ring.buffer = std::make_unique<std::byte[]>(LOG_RING_BYTES);
+    ring.write = 0;
+    ring.read = 0;
+    ring.n_dropped = 0;
+    ring.n_dropped_reported = 0;
+    ring.owner = 0;
+  }
+  logger.line.reserve(1024);
+};
+
+void
+start_logger(Logger& logger)
+{
+  if (logger.thread.joinable())
+    return;
+  logger.quit = false;
+  logger.thread = std::thread(log_worker, &logger);
+};
+
+void
+stop_logger(Logger& logger)
+{
+  if (!logger.thread.joinable()) {
+    flush_logger(logger);
+    return;
+  }
+
+  {
+    std::scoped_lock<std::mutex> lock(logger.mtx);
+    logger.quit = true;
+  }
+  logger.cv.notify_all();
+  logger.thread.join(); // drains once more before returning
+};
+
+void
+flush_logger(Logger& logger)
+{
+  std::array<uint64_t, MAX_LOG_RINGS> targets;
+  for (int i = 0; i < MAX_LOG_RINGS; i++)
+    targets[i] = logger.rings[i].write.load(std::memory_order_acquire);
+  const auto flushed = [&]() {
+    for (int i = 0; i < MAX_LOG_RINGS; i++)
+      if (logger.rings[i].read.load(std::memory_order_acquire) < targets[i])
+        return false;
+    return true;
+  };
+
+  if (!logger.thread.joinable()) {
+    std::scoped_lock<std::mutex> lock(logger.drain_mtx);
+    drain_log_rings(logger);
+    return;
+  }
+
+  std::unique_lock<std::mutex> lock(logger.mtx);
+  while (!flushed()) {
+    logger.cv.notify_all();
+    logger.cv.wait_for(lock, std::chrono::milliseconds(1));
+  }
+};
+
+void
+set_logger(Logger* logger)
+{
+  module_logger.store(logger, std::memory_order_release);
+};
+
+void
+log_write_args(const LogSite* site, const LogArg* args, const int n_args)
+{
+  Logger* logger = module_logger.load(std::memory_order_acquire);
+
+  // no logger yet. format here
+  if (logger == nullptr) {
+    std::string line;
+    append_log_prefix(line, site, SDL_GetTicksNS());
+    format_log_args(line, site->fmt, args, n_args);
+    SDL_Log("%s", line.c_str());
+    return;
+  }
+
+  LogRing* ring = claim_log_ring(*logger);
+  if (ring == nullptr) {
+    logger->n_no_ring.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+
+  size_t string_bytes = 0;
+  for (int i = 0; i < n_args; i++)
+    if (args[i].type == LogArgType::STR)
+      string_bytes += args[i].len;
+  const uint32_t size = align8(sizeof(LogRecordHeader) + n_args * sizeof(LogArg) + string_bytes);
+
+  // a record never wraps. if it doesnt fit before the end, pad to the end
+  const uint64_t w = ring->write.load(std::memory_order_relaxed);
+  const uint64_t offset = w & LOG_RING_MASK;
+  const uint64_t to_end = LOG_RING_BYTES - offset;
+  const uint64_t pad = size > to_end ? to_end : 0;
+  const uint64_t used = w - ring->read.load(std::memory_order_acquire);
+  if (used + pad + size > LOG_RING_BYTES) {
+    ring->n_dropped.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+
+  std::byte* buffer = ring->buffer.get();
+  if (pad > 0) {
+    const uint32_t pad_header[2] = { (uint32_t)pad, LOG_PAD };
+    std::memcpy(buffer + offset, pad_header, sizeof(pad_header));
+  }
+
+  std::byte* record = buffer + ((w + pad) & LOG_RING_MASK);
+  const LogRecordHeader header{ .size = size, .n_args = (uint32_t)n_args, .ns = SDL_GetTicksNS(), .site = site };
+  std::memcpy(record, &header, sizeof(header));
+  std::memcpy(record + sizeof(header), args, n_args * sizeof(LogArg));
+  std::byte* strings = record + sizeof(header) + n_args * sizeof(LogArg);
+  for (int i = 0; i < n_args; i++) {
+    if (args[i].type != LogArgType::STR)
+      continue;
+    std::memcpy(strings, args[i].p, args[i].len);
+    strings += args[i].len;
+  }
+
+  ring->write.store(w + pad + size, std::memory_order_release);
+};
+
+// printf conversions, one at a time. integers are widened to long long,
+// then cut back to the size the length modifier asked for
+void
+format_log_args(std::string& out, const char* fmt, const LogArg* args, const int n_args)
+{
+  int next = 0;
+  char spec[32];
+  char buf[512];
+
+  const char* c = fmt;
+  while (*c) {
+    if (*c != '%') {
+      const char* start = c;
+      while (*c && *c != '%')
+        c++;
+      out.append(start, c);
+      continue;
+    }
+    if (c[1] == '%') {
+      out.push_back('%');
+      c += 2;
+      continue;
+    }
+
+    // %[flags][width][.precision][length]conversion
+    const char* start = c++;
+    while (*c && std::strchr("-+ #0123456789.", *c))
+      c++;
+    const char* length = c;
+    while (*c && std::strchr("hljztL", *c))
+      c++;
+    const size_t n_length = (size_t)(c - length);
+    const char conversion = *c;
+    if (conversion == '\0') {
+      out.append(start, c);
+      break;
+    }
+    c++;
+
+    if (next >= n_args) {
+      out.append("(missing)");
+      continue;
+    }
+    const LogArg& arg = args[next++];
+
+    // the spec without its length modifier
+    const size_t n_flags = std::min((size_t)(length - start), sizeof(spec) - 4);
+    std::memcpy(spec, start, n_flags);
+    size_t n_spec = n_flags;
+
+    int bits = 32;
+    if (n_length == 2 && length[0] == 'h')
+      bits = 8;
+    else if (n_length == 1 && length[0] == 'h')
+      bits = 16;
+    else if (n_length == 1 && length[0] == 'l')
+      bits = (int)sizeof(long) * 8;
+    else if (n_length > 0 && length[0] != 'L')
+      bits = 64;
+
+    int n = 0;
+    switch (conversion) {
+      case 'd':
+      case 'i':
+      case 'u':
+      case 'x':
+      case 'X':
+      case 'o':
+      case 'c': {
+        uint64_t v = arg.type == LogArgType::F64 ? (uint64_t)(int64_t)arg.f : arg.u;
+        if (bits < 64)
+          v &= (1ull << bits) - 1;
+        if (conversion == 'c') {
+          spec[n_spec++] = 'c';
+          spec[n_spec] = '\0';
+          n = SDL_snprintf(buf, sizeof(buf), spec, (int)v);
+        } else if (conversion == 'd' || conversion == 'i') {
+          // sign extend from the modifier's size
+          const int64_t s = bits < 64 ? (int64_t)(v << (64 - bits)) >> (64 - bits) : (int64_t)v;
+          std::memcpy(spec + n_spec, "lld", 4);
+          n = SDL_snprintf(buf, sizeof(buf), spec, (long long)s);
+        } else {
+          spec[n_spec++] = 'l';
+          spec[n_spec++] = 'l';
+          spec[n_spec++] = conversion;
+          spec[n_spec] = '\0';
+          n = SDL_snprintf(buf, sizeof(buf), spec, (unsigned long long)v);
+        }
+        break;
+      }
+      case 'f':
+      case 'F':
+      case 'e':
+      case 'E':
+      case 'g':
+      case 'G':
+      case 'a':
+      case 'A': {
+        double v = arg.f;
+        if (arg.type == LogArgType::I64)
+          v = (double)arg.i;
+        else if (arg.type == LogArgType::U64)
+          v = (double)arg.u;
+        spec[n_spec++] = conversion;
+        spec[n_spec] = '\0';
+        n = SDL_snprintf(buf, sizeof(buf), spec, v);
+        break;
+      }
+      case 's': {
+        if (arg.type != LogArgType::STR) {
+          out.append("(not a string)");
+          continue;
+        }
+        const std::string_view str((const char*)arg.p, arg.len);
+        if (n_flags == 1) {
+          out.append(str); // the usual %s
+          continue;
+        }
+        const std::string copy(str);
+        spec[n_spec++] = 's';
+        spec[n_spec] = '\0';
+        n = SDL_snprintf(buf, sizeof(buf), spec, copy.c_str());
+        break;
+      }
+      case 'p':
+        n = SDL_snprintf(buf, sizeof(buf), "%p", arg.p);
+        break;
+      default:
+        out.append(start, c);
+        continue;
+    }
+    out.append(buf, (size_t)std::clamp(n, 0, (int)sizeof(buf) - 1));
+  }
+};
+
+} // namespace game2d
@@ -0,0 +1,218 @@
+#pragma once
+
+#include <SDL3/SDL.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+
+//
+// Asynchronous logging.
+//
+// LOG(INFO, PHYSICS, "fmt %i", x) writes a binary record to the calling thread's ring:
+// the call site (level, category and printf style format) and the raw arguments.
+// Nothing is formatted on the calling thread. The engine's log thread formats the
+// records and writes them with SDL_Log.
+//
+// Levels below GAME2D_LOG_MIN_LEVEL, and categories not in GAME2D_LOG_CATEGORIES,
+// are compiled out.
+//
+// A record holds a pointer to its call site. The game dll's records point in to the
+// dll, so the engine flushes before it unloads the dll.
+//
+
+namespace game2d {
+
+enum class LogLevel : uint8_t
+{
+  TRACE,
+  DEBUG,
+  INFO,
+  WARN,
+  ERR, // ERROR is a macro on windows
+  COUNT,
+};
+
+enum class LogCategory : uint8_t
+{
+  GENERAL,
+  INPUT,
+  PHYSICS,
+  COLLISION,
+  GAMEPLAY,
+  ASSETS,
+  COUNT,
+};
+
+// 0: trace, 1: debug, 2: info, 3: warn, 4: err
+#if !defined(GAME2D_LOG_MIN_LEVEL)
+#if defined(_DEBUG)
+#define GAME2D_LOG_MIN_LEVEL 1
+#else
+#define GAME2D_LOG_MIN_LEVEL 2
+#endif
+#endif
+
+// one bit per LogCategory
+#if !defined(GAME2D_LOG_CATEGORIES)
+#define GAME2D_LOG_CATEGORIES 0xffffffffu
+#endif
+
+constexpr bool
+log_compiled_in(const LogLevel level, const LogCategory category)
+{
+  return (int)level >= GAME2D_LOG_MIN_LEVEL && ((GAME2D_LOG_CATEGORIES >> (uint32_t)category) & 1u) != 0;
+};
+
+// one per call site, static
+struct LogSite
+{
+  LogLevel level;
+  LogCategory category;
+  const char* fmt;
+};
+
+enum class LogArgType : uint8_t
+{
+  I64,
+  U64,
+  F64,
+  PTR,
+  STR, // copied in to the record
+};
+
+struct LogArg
+{
+  LogArgType type = LogArgType::U64;
+  uint32_t len = 0; // STR only
+  union
+  {
+    int64_t i = 0;
+    uint64_t u;
+    double f;
+    const void* p;
+  };
+};
+
+constexpr size_t LOG_RING_BYTES = 64 << 10; // per thread
+constexpr int MAX_LOG_RINGS = 32;
+constexpr int MAX_LOG_ARGS = 16;
+constexpr uint32_t MAX_LOG_STRING = 256; // longer strings are cut
+
+// Single producer, single consumer.
+// The producer is whichever thread claimed it, the consumer is the log thread.
+// Positions only ever grow, the offset in to the buffer is pos % LOG_RING_BYTES.
+struct LogRing
+{
+  std::unique_ptr<std::byte[]> buffer;
+  alignas(64) std::atomic<uint64_t> write = 0;
+  alignas(64) std::atomic<uint64_t> read = 0;
+  alignas(64) std::atomic<uint64_t> n_dropped = 0; // records that did not fit
+  uint64_t n_dropped_reported = 0;                 // log thread only
+  std::atomic<SDL_ThreadID> owner = 0;
+};
+
+struct Logger
+{
+  std::array<LogRing, MAX_LOG_RINGS> rings;
+  std::mutex claim_mtx;
+  std::atomic<uint32_t> n_no_ring = 0; // records from threads after every ring was claimed
+
+  std::thread thread;
+  std::mutex mtx;
+  std::condition_variable cv;
+  bool quit = false; // guarded by mtx
+
+  std::mutex drain_mtx; // one consumer at a time
+  std::string line;     // formatting scratch, guarded by drain_mtx
+};
+
+void
+init_logger(Logger& logger);
+
+// engine only: the log thread must run code that outlives the game dll
+void
+start_logger(Logger& logger);
+
+// flushes, then stops the thread
+void
+stop_logger(Logger& logger);
+
+// returns once everything logged before the call has been written
+void
+flush_logger(Logger& logger);
+
+// per module. until it is set, records are formatted and written on the calling thread
+void
+set_logger(Logger* logger);
+
+void
+log_write_args(const LogSite* site, const LogArg* args, const int n_args);
+
+// formats a printf style string from packed args, appending to out
+void
+format_log_args(std::string& out, const char* fmt, const LogArg* args, const int n_args);
+
+template<typename T>
+inline LogArg
+make_log_arg(const T& value)
+{
+  using U = std::decay_t<T>;
+  LogArg arg;
+  if constexpr (std::is_same_v<U, const char*> || std::is_same_v<U, char*>) {
+    const char* str = value;
+    arg.type = LogArgType::STR;
+    arg.p = str ? str : "(null)";
+    arg.len = (uint32_t)std::min(std::strlen((const char*)arg.p), (size_t)MAX_LOG_STRING);
+  } else if constexpr (std::is_same_v<U, std::string> || std::is_same_v<U, std::string_view>) {
+    arg.type = LogArgType::STR;
+    arg.p = value.data();
+    arg.len = (uint32_t)std::min(value.size(), (size_t)MAX_LOG_STRING);
+  } else if constexpr (std::is_enum_v<U>) {
+    arg = make_log_arg(static_cast<std::underlying_type_t<U>>(value));
+  } else if constexpr (std::is_floating_point_v<U>) {
+    arg.type = LogArgType::F64;
+    arg.f = (double)value;
+  } else if constexpr (std::is_integral_v<U> && std::is_signed_v<U>) {
+    arg.type = LogArgType::I64;
+    arg.i = (int64_t)value;
+  } else if constexpr (std::is_integral_v<U>) {
+    arg.type = LogArgType::U64;
+    arg.u = (uint64_t)value;
+  } else if constexpr (std::is_pointer_v<U>) {
+    arg.type = LogArgType::PTR;
+    arg.p = (const void*)value;
+  } else
+    static_assert(sizeof(U) == 0, "type cannot be logged");
+  return arg;
+};
+
+template<typename... Args>
+inline void
+log_write(const LogSite* site, const Args&... args)
+{
+  static_assert(sizeof...(Args) <= MAX_LOG_ARGS, "too many log args");
+  const LogArg packed[sizeof...(Args) + 1] = { make_log_arg(args)..., LogArg{} };
+  log_write_args(site, packed, (int)sizeof...(Args));
+};
+
+// clang-format off
+#define LOG(level, category, fmt, ...)                                                                 \
+  do {                                                                                                 \
+    if constexpr (::game2d::log_compiled_in(::game2d::LogLevel::level, ::game2d::LogCategory::category)) { \
+      static constexpr ::game2d::LogSite log_site_{ ::game2d::LogLevel::level, ::game2d::LogCategory::category, fmt }; \
+      ::game2d::log_write(&log_site_, ##__VA_ARGS__);                                                  \
+    }                                                                                                  \
+  } while (0)
+// clang-format on
+
+} // namespace game2d
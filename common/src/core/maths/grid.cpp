@@ -0,0 +1,46 @@
+#include "core/pch.hpp"
+
+#include "core/maths/grid.hpp"
+
+#include <cmath>
+
+namespace game2d {
+
+int
+grid_position_to_index(const ivec2 gp, const int width)
+{
+  return gp.y * width + gp.x;
+};
+
+ivec2
+index_to_grid_position(const int index, const int width)
+{
+  return { index % width, index / width };
+};
+
+bool
+grid_position_in_bounds(const ivec2 gp, const int width, const int height)
+{
+  return gp.x >= 0 && gp.y >= 0 && gp.x < width && gp.y < height;
+};
+
+ivec2
+world_position_to_grid_position(const vec2 pos, const int cell_size)
+{
+  return { (int)std::floor(pos.x / (float)cell_size), (int)std::floor(pos.y / (float)cell_size) };
+};
+
+vec2
+grid_position_to_world_position(const ivec2 gp, const int cell_size)
+{
+  return { (float)(gp.x * cell_size), (float)(gp.y * cell_size) };
+};
+
+vec2
+grid_position_to_world_center(const ivec2 gp, const int cell_size)
+{
+  const float half = 0.5f * (float)cell_size;
+  return { (float)(gp.x * cell_size) + half, (float)(gp.y * cell_size) + half };
+};
+
+} // namespace game2d
@@ -0,0 +1,44 @@
+#pragma once
+
+#include "core/maths/vec.hpp"
+
+#include <array>
+
+// A dense grid of width * height cells, stored row by row.
+// Grid positions are in cells, world positions are in pixels.
+
+namespace game2d {
+
+// 4 orthogonal, then 4 diagonal
+constexpr std::array<ivec2, 8> GRID_NEIGHBOURS = { {
+  { 0, -1 },
+  { 1, 0 },
+  { 0, 1 },
+  { -1, 0 },
+  { 1, -1 },
+  { 1, 1 },
+  { -1, 1 },
+  { -1, -1 },
+} };
+
+int
+grid_position_to_index(const ivec2 gp, const int width);
+
+ivec2
+index_to_grid_position(const int index, const int width);
+
+bool
+grid_position_in_bounds(const ivec2 gp, const int width, const int height);
+
+// rounds down, so negative positions are in negative cells
+ivec2
+world_position_to_grid_position(const vec2 pos, const int cell_size);
+
+// the top left of the cell
+vec2
+grid_position_to_world_position(const ivec2 gp, const int cell_size);
+
+vec2
+grid_position_to_world_center(const ivec2 gp, const int cell_size);
+
+} // namespace game2d
@@ -28,6 +28,15 @@ struct vec2
 vec2
 operator*(const float other, const vec2& v);
 
+// grid positions, tiles
+struct ivec2
+{
+  int x = 0;
+  int y = 0;
+
+  bool operator==(const ivec2& other) const = default;
+};
+
 struct vec3
 {
   float x = 0.0f;
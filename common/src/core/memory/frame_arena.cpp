@@ -0,0 +1,89 @@
+#include "core/pch.hpp"
+
+#include "frame_arena.hpp"
+
+namespace game2d {
+
+void
+init_frame_arena(FrameArena& arena, const size_t capacity)
+{
+  arena.buffer = std::make_unique<std::byte[]>(capacity);
+  arena.capacity = capacity;
+  arena.used = 0;
+  arena.peak = 0;
+  arena.last_frame_bytes = 0;
+  arena.n_failed = 0;
+  arena.n_fallback = 0;
+  arena.resource = std::make_unique<FrameArenaResource>(arena);
+};
+
+void*
+arena_alloc(FrameArena& arena, const size_t size, const size_t align)
+{
+  const auto base = reinterpret_cast<uintptr_t>(arena.buffer.get());
+  const uintptr_t start = (base + arena.used + align - 1) & ~(uintptr_t)(align - 1);
+  const size_t end = (size_t)(start - base) + size;
+  if (arena.buffer == nullptr || end > arena.capacity) {
+    arena.n_failed++;
+    return nullptr;
+  }
+
+  arena.used = end;
+  arena.peak = std::max(arena.peak, arena.used);
+  return reinterpret_cast<void*>(start);
+};
+
+void
+reset_frame_arena(FrameArena& arena)
+{
+  arena.last_frame_bytes = arena.used;
+  arena.used = 0;
+};
+
+FrameArenaStats
+get_frame_arena_stats(const FrameArena& arena)
+{
+  FrameArenaStats stats;
+  stats.capacity = arena.capacity;
+  stats.last_frame_bytes = arena.last_frame_bytes;
+  stats.peak = arena.peak;
+  stats.n_failed = arena.n_failed;
+  stats.n_fallback = arena.n_fallback;
+  return stats;
+};
+
+std::pmr::memory_resource*
+frame_resource(FrameArena& arena)
+{
+  if (arena.resource == nullptr)
+    return std::pmr::new_delete_resource();
+  return arena.resource.get();
+};
+
+FrameArenaResource::FrameArenaResource(FrameArena& arena, std::pmr::memory_resource* upstream)
+  : arena(&arena)
+  , upstream(upstream) {};
+
+void*
+FrameArenaResource::do_allocate(size_t bytes, size_t align)
+{
+  if (void* p = arena_alloc(*arena, bytes, align))
+    return p;
+
+  // full. keep going on the heap, and count it so the arena can be resized
+  arena->n_failed--;
+  arena->n_fallback++;
+  return upstream->allocate(bytes, align);
+};
+
+void
+FrameArenaResource::do_deallocate(void* p, size_t bytes, size_t align)
+{
+  const auto* begin = arena->buffer.get();
+  const auto* ptr = static_cast<const std::byte*>(p);
+  if (ptr >= begin && ptr < begin + arena->capacity)
+    return; // freed on reset
+  upstream->deallocate(p, bytes, align);
+};
+
+} // namespace game2d
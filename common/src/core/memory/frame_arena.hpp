@@ -0,0 +1,79 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+
+namespace game2d {
+
+class FrameArenaResource;
+
+// A bump allocator over one fixed block.
+// Nothing is freed on its own, the whole arena is reset at once.
+// Not thread safe. Each thread that wants one gets its own.
+struct FrameArena
+{
+  std::unique_ptr<std::byte[]> buffer;
+  size_t capacity = 0;
+  size_t used = 0;
+  size_t peak = 0;             // most bytes used in any one frame
+  size_t last_frame_bytes = 0; // bytes used by the frame before the last reset
+  uint32_t n_failed = 0;       // allocations that did not fit
+  uint32_t n_fallback = 0;     // pmr allocations that went to the heap instead
+
+  std::unique_ptr<FrameArenaResource> resource;
+};
+
+// what the ui shows for an arena
+struct FrameArenaStats
+{
+  size_t capacity = 0;
+  size_t last_frame_bytes = 0;
+  size_t peak = 0;
+  uint32_t n_failed = 0;
+  uint32_t n_fallback = 0;
+};
+
+void
+init_frame_arena(FrameArena& arena, const size_t capacity);
+
+// returns nullptr when the arena is full
+void*
+arena_alloc(FrameArena& arena, const size_t size, const size_t align);
+
+// everything allocated before this is invalid after.
+// records how much the frame used.
+void
+reset_frame_arena(FrameArena& arena);
+
+FrameArenaStats
+get_frame_arena_stats(const FrameArena& arena);
+
+// std::pmr adapter, so containers can use the arena.
+// deallocate does nothing. when the arena is full, it falls back to the heap.
+std::pmr::memory_resource*
+frame_resource(FrameArena& arena);
+
+class FrameArenaResource : public std::pmr::memory_resource
+{
+public:
+  explicit FrameArenaResource(FrameArena& arena, std::pmr::memory_resource* upstream = std::pmr::new_delete_resource());
+
+private:
+  void* do_allocate(size_t bytes, size_t align) override;
+  void do_deallocate(void* p, size_t bytes, size_t align) override;
+  bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; };
+
+  FrameArena* arena;
+  std::pmr::memory_resource* upstream;
+};
+
+template<typename T>
+T*
+arena_alloc_array(FrameArena& arena, const size_t n)
+{
+  return static_cast<T*>(arena_alloc(arena, sizeof(T) * n, alignof(T)));
+};
+
+} // namespace game2d
@@ -0,0 +1,206 @@
+#include "core/pch.hpp"
+
+#include "tracked_allocator.hpp"
+
+#include <new>
+
+namespace game2d {
+
+// sits right in front of every pointer handed out
+struct AllocHeader
+{
+  MemoryTracker* tracker;
+  uint32_t size;
+  uint16_t offset; // from the start of the block
+  uint8_t tag;
+  uint8_t size_class; // NO_SIZE_CLASS if it came from the heap
+};
+static_assert(sizeof(AllocHeader) == 16);
+
+static constexpr uint8_t NO_SIZE_CLASS = 0xFF;
+static constexpr size_t POOL_PAGE_ALIGN = 64;
+
+static MemoryTracker* registry_memory = nullptr;
+
+static uint8_t
+find_size_class(const size_t bytes, const size_t align)
+{
+  if (align > POOL_PAGE_ALIGN)
+    return NO_SIZE_CLASS;
+  for (size_t i = 0; i < MEMORY_SIZE_CLASS_COUNT; i++)
+    if (bytes <= MEMORY_SIZE_CLASSES[i])
+      return (uint8_t)i;
+  return NO_SIZE_CLASS;
+};
+
+// blocks are a power of two and pages are 64 aligned,
+// so a block is aligned to its size, up to 64.
+static void*
+pool_alloc(MemoryPool& pool, const size_t block_size)
+{
+  std::lock_guard<std::mutex> lock(pool.mtx);
+  if (pool.free_list == nullptr) {
+    auto* page = static_cast<std::byte*>(::operator new(MEMORY_POOL_PAGE_SIZE, std::align_val_t{ POOL_PAGE_ALIGN }));
+    const size_t n = MEMORY_POOL_PAGE_SIZE / block_size;
+    for (size_t i = n; i > 0; i--) {
+      void* block = page + (i - 1) * block_size;
+      *static_cast<void**>(block) = pool.free_list;
+      pool.free_list = block;
+    }
+    pool.n_pages++;
+  }
+
+  void* block = pool.free_list;
+  pool.free_list = *static_cast<void**>(block);
+  pool.n_used++;
+  return block;
+};
+
+static void
+pool_free(MemoryPool& pool, void* block)
+{
+  std::lock_guard<std::mutex> lock(pool.mtx);
+  *static_cast<void**>(block) = pool.free_list;
+  pool.free_list = block;
+  pool.n_used--;
+};
+
+static void
+count_alloc(MemoryTracker& tracker, const MemoryTag tag, const size_t size)
+{
+  MemoryTagCounters& c = tracker.tags[(size_t)tag];
+  const size_t live = c.live.fetch_add(size, std::memory_order_relaxed) + size;
+  c.n_live.fetch_add(1, std::memory_order_relaxed);
+
+  size_t peak = c.peak.load(std::memory_order_relaxed);
+  while (live > peak && !c.peak.compare_exchange_weak(peak, live, std::memory_order_relaxed))
+    ;
+
+  const size_t budget = c.budget.load(std::memory_order_relaxed);
+  if (budget > 0 && live > budget) {
+    // only log the first one, or the log floods
+    if (c.n_over_budget.fetch_add(1, std::memory_order_relaxed) == 0)
+      SDL_Log("(Memory) %s over budget: %zu / %zu bytes", memory_tag_name(tag), live, budget);
+  }
+};
+
+const char*
+memory_tag_name(const MemoryTag tag)
+{
+  switch (tag) {
+    case MemoryTag::PHYSICS:
+      return "physics";
+    case MemoryTag::REGISTRY:
+      return "registry";
+    case MemoryTag::IMGUI:
+      return "imgui";
+    default:
+      return "unknown";
+  }
+};
+
+void*
+tracked_alloc(MemoryTracker* tracker, const MemoryTag tag, const size_t size, const size_t align)
+{
+  assert(size <= UINT32_MAX);
+  const size_t offset = std::max(sizeof(AllocHeader), align);
+  const uint8_t size_class = tracker ? find_size_class(offset + size, align) : NO_SIZE_CLASS;
+
+  std::byte* block = nullptr;
+  if (size_class != NO_SIZE_CLASS)
+    block = static_cast<std::byte*>(pool_alloc(tracker->pools[size_class], MEMORY_SIZE_CLASSES[size_class]));
+  else
+    block = static_cast<std::byte*>(::operator new(offset + size, std::align_val_t{ offset }));
+
+  std::byte* p = block + offset;
+  auto* header = reinterpret_cast<AllocHeader*>(p) - 1;
+  header->tracker = tracker;
+  header->size = (uint32_t)size;
+  header->offset = (uint16_t)offset;
+  header->tag = (uint8_t)tag;
+  header->size_class = size_class;
+
+  if (tracker)
+    count_alloc(*tracker, tag, size);
+  return p;
+};
+
+void
+tracked_free(void* p)
+{
+  if (p == nullptr)
+    return;
+
+  const auto* header = static_cast<const AllocHeader*>(p) - 1;
+  MemoryTracker* tracker = header->tracker;
+  std::byte* block = static_cast<std::byte*>(p) - header->offset;
+
+  if (tracker) {
+    MemoryTagCounters& c = tracker->tags[header->tag];
+    c.live.fetch_sub(header->size, std::memory_order_relaxed);
+    c.n_live.fetch_sub(1, std::memory_order_relaxed);
+  }
+
+  if (header->size_class != NO_SIZE_CLASS)
+    pool_free(tracker->pools[header->size_class], block);
+  else
+    ::operator delete(block, std::align_val_t{ header->offset });
+};
+
+void
+set_memory_budget(MemoryTracker& tracker, const MemoryTag tag, const size_t bytes)
+{
+  MemoryTagCounters& c = tracker.tags[(size_t)tag];
+  c.budget.store(bytes, std::memory_order_relaxed);
+  c.n_over_budget.store(0, std::memory_order_relaxed);
+};
+
+void
+export_memory_stats(MemoryTracker& tracker, MemoryStats& out)
+{
+  for (size_t i = 0; i < MEMORY_TAG_COUNT; i++) {
+    const MemoryTagCounters& c = tracker.tags[i];
+    MemoryTagStats& s = out.tags[i];
+    s.live = c.live.load(std::memory_order_relaxed);
+    s.peak = c.peak.load(std::memory_order_relaxed);
+    s.budget = c.budget.load(std::memory_order_relaxed);
+    s.n_live = c.n_live.load(std::memory_order_relaxed);
+    s.n_over_budget = c.n_over_budget.load(std::memory_order_relaxed);
+  }
+
+  out.pool_reserved = 0;
+  out.pool_used = 0;
+  for (size_t i = 0; i < MEMORY_SIZE_CLASS_COUNT; i++) {
+    MemoryPool& pool = tracker.pools[i];
+    std::lock_guard<std::mutex> lock(pool.mtx);
+    out.pool_reserved += (size_t)pool.n_pages * MEMORY_POOL_PAGE_SIZE;
+    out.pool_used += (size_t)pool.n_used * MEMORY_SIZE_CLASSES[i];
+  }
+};
+
+void*
+imgui_tracked_alloc(size_t size, void* user_data)
+{
+  return tracked_alloc(static_cast<MemoryTracker*>(user_data), MemoryTag::IMGUI, size, alignof(std::max_align_t));
+};
+
+void
+imgui_tracked_free(void* p, void* user_data)
+{
+  (void)user_data;
+  tracked_free(p);
+};
+
+void
+set_registry_memory(MemoryTracker* tracker)
+{
+  registry_memory = tracker;
+};
+
+MemoryTracker*
+get_registry_memory()
+{
+  return registry_memory;
+};
+
+} // namespace game2d
@@ -0,0 +1,127 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+
+namespace game2d {
+
+// which subsystem an allocation is charged to
+enum class MemoryTag : uint8_t
+{
+  PHYSICS,  // box2d
+  REGISTRY, // entt
+  IMGUI,
+  COUNT,
+};
+constexpr size_t MEMORY_TAG_COUNT = (size_t)MemoryTag::COUNT;
+
+const char*
+memory_tag_name(const MemoryTag tag);
+
+// small blocks come from size-class pools, anything bigger goes to the heap.
+// sizes include the header in front of each block.
+constexpr size_t MEMORY_SIZE_CLASSES[] = { 32, 64, 128, 256, 512, 1024 };
+constexpr size_t MEMORY_SIZE_CLASS_COUNT = std::size(MEMORY_SIZE_CLASSES);
+constexpr size_t MEMORY_POOL_PAGE_SIZE = 64 * 1024;
+
+struct MemoryTagCounters
+{
+  std::atomic<size_t> live{ 0 }; // bytes requested and not freed
+  std::atomic<size_t> peak{ 0 };
+  std::atomic<size_t> budget{ 0 }; // 0 is no budget
+  std::atomic<uint32_t> n_live{ 0 };
+  std::atomic<uint32_t> n_over_budget{ 0 }; // allocations that went over budget
+};
+
+struct MemoryPool
+{
+  std::mutex mtx;
+  void* free_list = nullptr;
+  uint32_t n_pages = 0;
+  uint32_t n_used = 0; // blocks handed out
+};
+
+// Owned by the engine, shared with the game dll.
+// Every allocation has a header that points back at its tracker,
+// so it can be freed from either module.
+// Pool pages are never given back, so the tracker has to outlive everything allocated from it.
+struct MemoryTracker
+{
+  std::array<MemoryTagCounters, MEMORY_TAG_COUNT> tags;
+  std::array<MemoryPool, MEMORY_SIZE_CLASS_COUNT> pools;
+};
+
+// what the ui shows for a tag
+struct MemoryTagStats
+{
+  size_t live = 0;
+  size_t peak = 0;
+  size_t budget = 0;
+  uint32_t n_live = 0;
+  uint32_t n_over_budget = 0;
+};
+
+struct MemoryStats
+{
+  std::array<MemoryTagStats, MEMORY_TAG_COUNT> tags;
+  size_t pool_reserved = 0; // bytes in pool pages
+  size_t pool_used = 0;     // bytes in blocks handed out. the rest is free or lost to rounding up
+};
+
+// tracker can be nullptr, then nothing is counted.
+void*
+tracked_alloc(MemoryTracker* tracker, const MemoryTag tag, const size_t size, const size_t align);
+
+void
+tracked_free(void* p);
+
+void
+set_memory_budget(MemoryTracker& tracker, const MemoryTag tag, const size_t bytes);
+
+void
+export_memory_stats(MemoryTracker& tracker, MemoryStats& out);
+
+// ImGui::SetAllocatorFunctions() callbacks. user_data is the tracker.
+// imgui keeps these per module, so the game dll sets them again.
+void*
+imgui_tracked_alloc(size_t size, void* user_data);
+
+void
+imgui_tracked_free(void* p, void* user_data);
+
+// the tracker used by RegistryAllocator in this module.
+// set by the engine, and by the game in game_init().
+void
+set_registry_memory(MemoryTracker* tracker);
+
+MemoryTracker*
+get_registry_memory();
+
+// stateless, so registries and their pools can be moved and swapped freely
+template<typename T>
+struct RegistryAllocator
+{
+  using value_type = T;
+  using is_always_equal = std::true_type;
+
+  RegistryAllocator() = default;
+  template<typename U>
+  RegistryAllocator(const RegistryAllocator<U>&) noexcept {};
+
+  T* allocate(const size_t n)
+  {
+    return static_cast<T*>(tracked_alloc(get_registry_memory(), MemoryTag::REGISTRY, sizeof(T) * n, alignof(T)));
+  };
+  void deallocate(T* p, const size_t) noexcept { tracked_free(p); };
+
+  template<typename U>
+  bool operator==(const RegistryAllocator<U>&) const noexcept
+  {
+    return true;
+  };
+};
+
+} // namespace game2d
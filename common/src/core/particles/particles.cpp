@@ -0,0 +1,154 @@
+#include "core/pch.hpp"
+
+#include "core/particles/particles.hpp"
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+#include <emmintrin.h>
+#define PARTICLES_USE_SSE
+#endif
+
+namespace game2d {
+
+ParticleBuffer::ParticleBuffer()
+{
+  for (auto* arr : { &pos_x, &pos_y, &vel_x, &vel_y, &age, &inv_lifetime, &size, &col_r, &col_g, &col_b, &alpha_start, &alpha })
+    arr->resize(MAX_PARTICLES, 0.0f);
+};
+
+uint32_t
+emit_particles(ParticleBuffer& p, RandomState& rnd, const vec2 pos, const ParticleDesc& desc, const uint32_t n)
+{
+  const uint32_t n_free = MAX_PARTICLES - p.count;
+  const uint32_t n_emit = std::min(n, n_free);
+
+  for (uint32_t i = p.count; i < p.count + n_emit; i++) {
+    const float lifetime = random(rnd, desc.lifetime_min, desc.lifetime_max);
+    p.pos_x[i] = pos.x;
+    p.pos_y[i] = pos.y;
+    p.vel_x[i] = random(rnd, desc.velocity_min.x, desc.velocity_max.x);
+    p.vel_y[i] = random(rnd, desc.velocity_min.y, desc.velocity_max.y);
+    p.age[i] = 0.0f;
+    p.inv_lifetime[i] = lifetime > 0.0f ? 1.0f / lifetime : 1e9f; // dies next update
+    p.size[i] = desc.size;
+    p.col_r[i] = desc.colour.r;
+    p.col_g[i] = desc.colour.g;
+    p.col_b[i] = desc.colour.b;
+    p.alpha_start[i] = desc.colour.a;
+    p.alpha[i] = desc.colour.a;
+  }
+
+  p.count += n_emit;
+  return n_emit;
+};
+
+static void
+swap_remove(ParticleBuffer& p, const uint32_t i)
+{
+  const uint32_t last = p.count - 1;
+  p.pos_x[i] = p.pos_x[last];
+  p.pos_y[i] = p.pos_y[last];
+  p.vel_x[i] = p.vel_x[last];
+  p.vel_y[i] = p.vel_y[last];
+  p.age[i] = p.age[last];
+  p.inv_lifetime[i] = p.inv_lifetime[last];
+  p.size[i] = p.size[last];
+  p.col_r[i] = p.col_r[last];
+  p.col_g[i] = p.col_g[last];
+  p.col_b[i] = p.col_b[last];
+  p.alpha_start[i] = p.alpha_start[last];
+  p.alpha[i] = p.alpha[last];
+  p.count--;
+};
+
+void
+update_particles(ParticleBuffer& p, const float dt)
+{
+  const uint32_t n = p.count;
+  const float damp = 1.0f / (1.0f + dt * p.damping);
+
+  float* pos_x = p.pos_x.data();
+  float* pos_y = p.pos_y.data();
+  float* vel_x = p.vel_x.data();
+  float* vel_y = p.vel_y.data();
+  float* age = p.age.data();
+  const float* inv_lifetime = p.inv_lifetime.data();
+  const float* alpha_start = p.alpha_start.data();
+  float* alpha = p.alpha.data();
+
+  uint32_t i = 0;
+
+#if defined(PARTICLES_USE_SSE)
+  const __m128 v_dt = _mm_set1_ps(dt);
+  const __m128 v_damp = _mm_set1_ps(damp);
+  const __m128 v_one = _mm_set1_ps(1.0f);
+  for (; i + 4 <= n; i += 4) {
+    const __m128 vx = _mm_mul_ps(_mm_loadu_ps(vel_x + i), v_damp);
+    const __m128 vy = _mm_mul_ps(_mm_loadu_ps(vel_y + i), v_damp);
+    _mm_storeu_ps(vel_x + i, vx);
+    _mm_storeu_ps(vel_y + i, vy);
+    _mm_storeu_ps(pos_x + i, _mm_add_ps(_mm_loadu_ps(pos_x + i), _mm_mul_ps(vx, v_dt)));
+    _mm_storeu_ps(pos_y + i, _mm_add_ps(_mm_loadu_ps(pos_y + i), _mm_mul_ps(vy, v_dt)));
+
+    const __m128 a = _mm_add_ps(_mm_loadu_ps(age + i), v_dt);
+    _mm_storeu_ps(age + i, a);
+
+    const __m128 t = _mm_min_ps(_mm_mul_ps(a, _mm_loadu_ps(inv_lifetime + i)), v_one);
+    _mm_storeu_ps(alpha + i, _mm_mul_ps(_mm_loadu_ps(alpha_start + i), _mm_sub_ps(v_one, t)));
+  }
+#endif
+
+  for (; i < n; i++) {
+    vel_x[i] *= damp;
+    vel_y[i] *= damp;
+    pos_x[i] += vel_x[i] * dt;
+    pos_y[i] += vel_y[i] * dt;
+    age[i] += dt;
+    const float t = std::min(age[i] * inv_lifetime[i], 1.0f);
+    alpha[i] = alpha_start[i] * (1.0f - t);
+  }
+
+  // compact. dont advance i after a swap-remove,
+  // as the particle moved in to i has not been checked yet.
+  i = 0;
+  while (i < p.count) {
+    if (p.age[i] * p.inv_lifetime[i] >= 1.0f)
+      swap_remove(p, i);
+    else
+      i++;
+  }
+};
+
+void
+pack_particles(const ParticleBuffer& p, std::vector<SpriteInstance>& out)
+{
+  out.resize(p.count);
+
+  for (uint32_t i = 0; i < p.count; i++) {
+    const float half_size = 0.5f * p.size[i];
+    SpriteInstance& inst = out[i];
+    inst.x = p.pos_x[i] - half_size; // sprites are positioned from the top-left
+    inst.y = p.pos_y[i] - half_size;
+    inst.z = 0.0f;
+    inst.rotation = 0.0f;
+    inst.w = p.size[i];
+    inst.h = p.size[i];
+    inst.p1 = 0.0f;
+    inst.p2 = 0.0f;
+    inst.tex_u = 0.0f;
+    inst.tex_v = 0.0f;
+    inst.tex_w = 1.0f;
+    inst.tex_h = 1.0f;
+    inst.colour[0] = p.col_r[i];
+    inst.colour[1] = p.col_g[i];
+    inst.colour[2] = p.col_b[i];
+    inst.colour[3] = p.alpha[i];
+  }
+};
+
+void
+clear_particles(ParticleBuffer& p)
+{
+  p.count = 0;
+};
+
+} // namespace game2d
@@ -0,0 +1,64 @@
+#pragma once
+
+#include "core/common.hpp"
+#include "core/maths/vec.hpp"
+
+#include <cstdint>
+#include <vector>
+
+namespace game2d {
+
+constexpr uint32_t MAX_PARTICLES = 131072;
+
+// how a burst (or an emitter) spawns particles
+struct ParticleDesc
+{
+  vec2 velocity_min{ -100, -100 };
+  vec2 velocity_max{ 100, 100 };
+  float lifetime_min = 0.25f;
+  float lifetime_max = 0.5f;
+  float size = 4.0f;
+  ColourComponent colour{};
+};
+
+// Particles live outside the registry.
+// Each attribute is its own array so the update kernel
+// can stream through 4 particles at a time.
+// Dead particles are swap-removed, so [0, count) is always alive.
+struct ParticleBuffer
+{
+  uint32_t count = 0;
+  float damping = 2.0f;
+
+  std::vector<float> pos_x;
+  std::vector<float> pos_y;
+  std::vector<float> vel_x;
+  std::vector<float> vel_y;
+  std::vector<float> age;
+  std::vector<float> inv_lifetime;
+  std::vector<float> size;
+  std::vector<float> col_r;
+  std::vector<float> col_g;
+  std::vector<float> col_b;
+  std::vector<float> alpha_start;
+  std::vector<float> alpha;
+
+  ParticleBuffer();
+};
+
+// returns the number of particles actually emitted (the buffer may be full)
+uint32_t
+emit_particles(ParticleBuffer& p, RandomState& rnd, const vec2 pos, const ParticleDesc& desc, const uint32_t n);
+
+// integrate, age, fade, then compact the dead particles
+void
+update_particles(ParticleBuffer& p, const float dt);
+
+// writes one SpriteInstance per live particle, reusing out's capacity
+void
+pack_particles(const ParticleBuffer& p, std::vector<SpriteInstance>& out);
+
+void
+clear_particles(ParticleBuffer& p);
+
+} // namespace game2d
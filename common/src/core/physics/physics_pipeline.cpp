@@ -0,0 +1,87 @@
+#include "core/pch.hpp"
+
+#include "core/physics/physics_pipeline.hpp"
+
+namespace game2d {
+
+static void
+physics_worker(PhysicsPipeline* p)
+{
+  tracy::SetThreadName("PhysicsThread");
+
+  std::unique_lock<std::mutex> lock(p->mtx);
+  while (true) {
+    p->cv.wait(lock, [p]() { return p->quit || p->step_requested; });
+    if (p->quit)
+      return;
+
+    lock.unlock();
+    {
+      ZoneScopedN("(PhysicsThread) b2World_Step()");
+      b2World_Step(p->world_id, p->dt, p->substeps);
+    }
+    lock.lock();
+
+    p->step_requested = false;
+    p->cv.notify_all();
+  }
+};
+
+void
+start_physics_pipeline(PhysicsPipeline& p)
+{
+  if (p.thread.joinable())
+    return;
+  p.quit = false;
+  p.thread = std::thread(physics_worker, &p);
+};
+
+void
+stop_physics_pipeline(PhysicsPipeline& p)
+{
+  if (!p.thread.joinable())
+    return;
+
+  wait_physics_step(p);
+  {
+    std::scoped_lock<std::mutex> lock(p.mtx);
+    p.quit = true;
+  }
+  p.cv.notify_all();
+  p.thread.join();
+};
+
+void
+kick_physics_step(PhysicsPipeline& p, const b2WorldId world_id, const float dt, const int substeps)
+{
+  if (!p.thread.joinable()) {
+    b2World_Step(world_id, dt, substeps);
+    p.in_flight = true;
+    return;
+  }
+
+  {
+    std::scoped_lock<std::mutex> lock(p.mtx);
+    assert(!p.step_requested);
+    p.world_id = world_id;
+    p.dt = dt;
+    p.substeps = substeps;
+    p.step_requested = true;
+    p.in_flight = true;
+  }
+  p.cv.notify_all();
+};
+
+bool
+wait_physics_step(PhysicsPipeline& p)
+{
+  ZoneScopedN("wait_physics_step()");
+  std::unique_lock<std::mutex> lock(p.mtx);
+  p.cv.wait(lock, [&p]() { return !p.step_requested; });
+
+  const bool had_step = p.in_flight;
+  p.in_flight = false;
+  return had_step;
+};
+
+} // namespace game2d
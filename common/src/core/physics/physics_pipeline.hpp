@@ -0,0 +1,51 @@
+#pragma once
+
+#include <box2d/box2d.h>
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+namespace game2d {
+
+// Steps the b2World on a worker thread owned by the engine,
+// so the gamethread can process the previous step's results at the same time.
+//
+// Only the b2World is touched by the worker. While a step is in flight
+// the gamethread must not call in to box2d for that world.
+struct PhysicsPipeline
+{
+  // set by the engine before game_init()
+  bool pipelined = false;
+
+  std::thread thread;
+  std::mutex mtx;
+  std::condition_variable cv;
+
+  // guarded by mtx
+  bool quit = false;
+  bool step_requested = false;
+  bool in_flight = false; // kicked, and not waited on yet
+
+  // set in kick, read by the worker
+  b2WorldId world_id = b2_nullWorldId;
+  float dt = 0.0f;
+  int substeps = 4;
+};
+
+// engine only: the worker must run code that outlives the game dll
+void
+start_physics_pipeline(PhysicsPipeline& p);
+
+void
+stop_physics_pipeline(PhysicsPipeline& p);
+
+// steps inline if the worker is not running
+void
+kick_physics_step(PhysicsPipeline& p, const b2WorldId world_id, const float dt, const int substeps);
+
+// returns true if a step was in flight, i.e. there are new results to read
+bool
+wait_physics_step(PhysicsPipeline& p);
+
+} // namespace game2d
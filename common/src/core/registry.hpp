@@ -0,0 +1,12 @@
+#pragma once
+
+#include "core/memory/tracked_allocator.hpp"
+
+#include <entt/fwd.hpp>
+
+namespace game2d {
+
+// the registry's allocations are charged to MemoryTag::REGISTRY
+using Registry = entt::basic_registry<entt::entity, RegistryAllocator<entt::entity>>;
+
+} // namespace game2d
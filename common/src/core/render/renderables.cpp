@@ -0,0 +1,64 @@
+#include "core/pch.hpp"
+
+#include "core/render/renderables.hpp"
+
+namespace game2d {
+
+void
+extract_renderables(Registry& r, std::vector<Renderable>& out)
+{
+  const auto group = get_renderables_group(r);
+  out.resize(group.size());
+
+  size_t i = 0;
+  for (const auto& [e, t_c, col_c] : group.each())
+    out[i++] = Renderable{ .transform = t_c, .colour = col_c };
+};
+
+void
+pack_sprite_instances(std::span<const Renderable> renderables, SpriteInstance* out)
+{
+  for (size_t i = 0; i < renderables.size(); i++) {
+    const auto& transform = renderables[i].transform;
+    SpriteInstance& inst = out[i];
+    inst.x = transform.pos.x;
+    inst.y = transform.pos.y;
+    inst.z = 0.0f;
+    inst.rotation = transform.rotation_radians;
+    inst.w = transform.size.x;
+    inst.h = transform.size.y;
+
+    inst.p1 = 0.0f;
+    inst.p2 = 0.0f;
+    inst.tex_u = 0.0f;
+    inst.tex_v = 0.0f;
+    inst.tex_w = 1.0f;
+    inst.tex_h = 1.0f;
+
+    const auto& colour = renderables[i].colour;
+    inst.colour[0] = colour.r;
+    inst.colour[1] = colour.g;
+    inst.colour[2] = colour.b;
+    inst.colour[3] = colour.a;
+  }
+};
+
+void
+copy_render_data(const RenderData& from, GameUIData& to)
+{
+  to.renderable = from.renderable; // take a copy
+  to.n_particles = (int)from.particles.size();
+  to.ui_data = from.ui_data;
+  to.camera_pos = from.camera_pos;
+};
+
+uint32_t
+copy_particle_instances(const RenderData& from, SpriteInstance* out, const uint32_t max)
+{
+  const auto n = (uint32_t)std::min(from.particles.size(), (size_t)max);
+  if (n > 0)
+    SDL_memcpy(out, from.particles.data(), n * sizeof(SpriteInstance));
+  return n;
+};
+
+} // namespace game2d
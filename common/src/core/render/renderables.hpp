@@ -0,0 +1,38 @@
+#pragma once
+
+#include "core/common.hpp"
+
+#include <entt/entt.hpp>
+
+#include <span>
+#include <vector>
+
+namespace game2d {
+
+// Owning group: transforms and colours of renderables are kept packed at the
+// front of both pools, in the same order, so extraction is a linear scan.
+// Nothing else may own TransformComponent or ColourComponent.
+inline auto
+get_renderables_group(Registry& r)
+{
+  return r.group<TransformComponent, ColourComponent>();
+};
+
+// resizes out, then copies each renderable in to it
+void
+extract_renderables(Registry& r, std::vector<Renderable>& out);
+
+// writes one instance per renderable. out is usually a mapped gpu transfer buffer
+void
+pack_sprite_instances(std::span<const Renderable> renderables, SpriteInstance* out);
+
+// the renderthread's side of the handoff, without the particles. caller holds from.mtx
+void
+copy_render_data(const RenderData& from, GameUIData& to);
+
+// particles are already in the instance layout, so they are copied straight
+// from the read buffer to out. returns how many, at most max. caller holds from.mtx
+uint32_t
+copy_particle_instances(const RenderData& from, SpriteInstance* out, const uint32_t max);
+
+} // namespace game2d
@@ -0,0 +1,81 @@
+#include "core/pch.hpp"
+
+#include "fixed_step_scheduler.hpp"
+
+#include <bit>
+
+namespace game2d {
+
+void
+set_tick_rate(FixedStepScheduler& s, const float hz)
+{
+  const float clamped_hz = std::clamp(hz, 10.0f, 1000.0f);
+  set_tick_ns(s, (Uint64)(1e9 / (double)clamped_hz));
+};
+
+void
+set_tick_ns(FixedStepScheduler& s, const Uint64 ns_per_tick)
+{
+  s.ns_per_tick = std::max(ns_per_tick, Uint64(1));
+  s.accumulator = std::min(s.accumulator, s.ns_per_tick);
+  s.avg_tick_ns = 0;
+  s.stats.tick_hz = (float)(1e9 / (double)s.ns_per_tick);
+};
+
+float
+get_fixed_dt(const FixedStepScheduler& s)
+{
+  return (float)(1e-9 * (double)s.ns_per_tick);
+};
+
+Uint32
+advance_fixed_steps(FixedStepScheduler& s, const Uint64 dt_ns)
+{
+  s.accumulator += dt_ns;
+  Uint64 steps = s.accumulator / s.ns_per_tick;
+
+  // catching up makes the next frame even longer
+  const bool over_budget = s.avg_tick_ns > s.ns_per_tick;
+  const Uint64 max_steps = over_budget ? 1 : (Uint64)std::max(s.max_steps_per_frame, 1);
+
+  Uint64 dropped_ns = 0;
+  if (steps > max_steps) {
+    const Uint64 dropped = steps - max_steps;
+    dropped_ns = dropped * s.ns_per_tick;
+    s.stats.n_dropped += dropped;
+    steps = max_steps;
+  }
+  s.accumulator -= steps * s.ns_per_tick + dropped_ns;
+
+  s.window_wall_ns += dt_ns;
+  s.window_dropped_ns += dropped_ns;
+  if (s.window_wall_ns >= 1'000'000'000) {
+    const Uint64 dropped = std::min(s.window_dropped_ns, s.window_wall_ns);
+    s.stats.time_dilation = (float)(s.window_wall_ns - dropped) / (float)s.window_wall_ns;
+    s.window_wall_ns = 0;
+    s.window_dropped_ns = 0;
+  }
+
+  s.stats.max_steps_per_frame = s.max_steps_per_frame;
+  s.stats.steps_last_frame = (int)steps;
+  return (Uint32)steps;
+};
+
+void
+record_fixed_tick(FixedStepScheduler& s, const Uint64 tick_ns)
+{
+  // ema, 1/8th weight to the new sample
+  if (s.avg_tick_ns == 0)
+    s.avg_tick_ns = tick_ns;
+  else
+    s.avg_tick_ns = s.avg_tick_ns - s.avg_tick_ns / 8 + tick_ns / 8;
+
+  const Uint64 us = tick_ns / 1000;
+  const int bucket = std::min((int)std::bit_width(us), N_TICK_HISTOGRAM_BUCKETS - 1);
+  s.stats.histogram[bucket]++;
+  s.stats.n_ticks++;
+  if (tick_ns > s.ns_per_tick)
+    s.stats.n_over_budget++;
+};
+
+} // namespace game2d
@@ -0,0 +1,47 @@
+#pragma once
+
+#include "core/common.hpp"
+
+#include <SDL3/SDL.h>
+
+namespace game2d {
+
+// Decides how many fixed updates to run each frame.
+// At most max_steps_per_frame are run. Any time beyond that is dropped,
+// so the game slows down (time dilation) instead of spiralling.
+// If a fixed update costs more than the time it simulates,
+// only one step is run per frame until it recovers.
+struct FixedStepScheduler
+{
+  Uint64 ns_per_tick = (Uint64)(1e9 / 60.0);
+  int max_steps_per_frame = 4;
+  Uint64 accumulator = 0;
+
+  // moving average of the fixed update cost
+  Uint64 avg_tick_ns = 0;
+
+  // dilation is measured over a window of wall time
+  Uint64 window_wall_ns = 0;
+  Uint64 window_dropped_ns = 0;
+
+  FixedStepStats stats;
+};
+
+void
+set_tick_rate(FixedStepScheduler& s, const float hz);
+
+void
+set_tick_ns(FixedStepScheduler& s, const Uint64 ns_per_tick);
+
+float
+get_fixed_dt(const FixedStepScheduler& s);
+
+// returns the number of fixed updates to run this frame
+Uint32
+advance_fixed_steps(FixedStepScheduler& s, const Uint64 dt_ns);
+
+// call with the cost of each fixed update
+void
+record_fixed_tick(FixedStepScheduler& s, const Uint64 tick_ns);
+
+} // namespace game2d
@@ -0,0 +1,334 @@
+#include "core/pch.hpp"
+
+#include "input_replay.hpp"
+
+#include "sdl_exception.hpp"
+
+namespace game2d {
+
+static bool
+write_f32(SDL_IOStream* io, const float f)
+{
+  uint32_t u;
+  SDL_memcpy(&u, &f, sizeof(u));
+  return SDL_WriteU32LE(io, u);
+};
+
+static bool
+read_f32(SDL_IOStream* io, float& f)
+{
+  uint32_t u = 0;
+  if (!SDL_ReadU32LE(io, &u))
+    return false;
+  SDL_memcpy(&f, &u, sizeof(f));
+  return true;
+};
+
+bool
+is_replay_event(const SDL_Event& evt)
+{
+  switch (evt.type) {
+    case SDL_EVENT_KEY_DOWN:
+    case SDL_EVENT_KEY_UP:
+    case SDL_EVENT_MOUSE_BUTTON_DOWN:
+    case SDL_EVENT_MOUSE_BUTTON_UP:
+    case SDL_EVENT_JOYSTICK_ADDED:
+    case SDL_EVENT_JOYSTICK_REMOVED:
+    case SDL_EVENT_JOYSTICK_BUTTON_DOWN:
+    case SDL_EVENT_JOYSTICK_BUTTON_UP:
+    case SDL_EVENT_JOYSTICK_AXIS_MOTION:
+    case SDL_EVENT_GAMEPAD_ADDED:
+    case SDL_EVENT_GAMEPAD_REMOVED:
+    case SDL_EVENT_GAMEPAD_BUTTON_DOWN:
+    case SDL_EVENT_GAMEPAD_BUTTON_UP:
+    case SDL_EVENT_GAMEPAD_AXIS_MOTION:
+      return true;
+    default:
+      return false;
+  }
+};
+
+// only the fields the game reads. returns false for a type that is not recorded
+static bool
+write_replay_event(SDL_IOStream* io, const SDL_Event& evt)
+{
+  bool ok = true;
+  ok &= SDL_WriteU32LE(io, evt.type);
+  ok &= SDL_WriteU64LE(io, evt.common.timestamp);
+
+  switch (evt.type) {
+    case SDL_EVENT_KEY_DOWN:
+    case SDL_EVENT_KEY_UP:
+      ok &= SDL_WriteU32LE(io, evt.key.which);
+      ok &= SDL_WriteU32LE(io, evt.key.scancode);
+      ok &= SDL_WriteU32LE(io, evt.key.key);
+      ok &= SDL_WriteU16LE(io, evt.key.mod);
+      ok &= SDL_WriteU16LE(io, evt.key.raw);
+      ok &= SDL_WriteU8(io, evt.key.down ? 1 : 0);
+      ok &= SDL_WriteU8(io, evt.key.repeat ? 1 : 0);
+      return ok;
+    case SDL_EVENT_MOUSE_BUTTON_DOWN:
+    case SDL_EVENT_MOUSE_BUTTON_UP:
+      ok &= SDL_WriteU32LE(io, evt.button.which);
+      ok &= SDL_WriteU8(io, evt.button.button);
+      ok &= SDL_WriteU8(io, evt.button.down ? 1 : 0);
+      ok &= SDL_WriteU8(io, evt.button.clicks);
+      ok &= write_f32(io, evt.button.x);
+      ok &= write_f32(io, evt.button.y);
+      return ok;
+    case SDL_EVENT_JOYSTICK_ADDED:
+    case SDL_EVENT_JOYSTICK_REMOVED:
+      return ok && SDL_WriteU32LE(io, evt.jdevice.which);
+    case SDL_EVENT_GAMEPAD_ADDED:
+    case SDL_EVENT_GAMEPAD_REMOVED:
+      return ok && SDL_WriteU32LE(io, evt.gdevice.which);
+    case SDL_EVENT_JOYSTICK_BUTTON_DOWN:
+    case SDL_EVENT_JOYSTICK_BUTTON_UP:
+      ok &= SDL_WriteU32LE(io, evt.jbutton.which);
+      ok &= SDL_WriteU8(io, evt.jbutton.button);
+      ok &= SDL_WriteU8(io, evt.jbutton.down ? 1 : 0);
+      return ok;
+    case SDL_EVENT_GAMEPAD_BUTTON_DOWN:
+    case SDL_EVENT_GAMEPAD_BUTTON_UP:
+      ok &= SDL_WriteU32LE(io, evt.gbutton.which);
+      ok &= SDL_WriteU8(io, evt.gbutton.button);
+      ok &= SDL_WriteU8(io, evt.gbutton.down ? 1 : 0);
+      return ok;
+    case SDL_EVENT_JOYSTICK_AXIS_MOTION:
+      ok &= SDL_WriteU32LE(io, evt.jaxis.which);
+      ok &= SDL_WriteU8(io, evt.jaxis.axis);
+      ok &= SDL_WriteS16LE(io, evt.jaxis.value);
+      return ok;
+    case SDL_EVENT_GAMEPAD_AXIS_MOTION:
+      ok &= SDL_WriteU32LE(io, evt.gaxis.which);
+      ok &= SDL_WriteU8(io, evt.gaxis.axis);
+      ok &= SDL_WriteS16LE(io, evt.gaxis.value);
+      return ok;
+    default:
+      return false;
+  }
+};
+
+// returns false if the record is truncated, or a type that is never written
+static bool
+read_replay_event(SDL_IOStream* io, SDL_Event& evt)
+{
+  uint32_t type = 0;
+  uint64_t timestamp = 0;
+  uint8_t down = 0;
+  uint8_t repeat = 0;
+  bool ok = true;
+  ok &= SDL_ReadU32LE(io, &type);
+  ok &= SDL_ReadU64LE(io, &timestamp);
+  if (!ok)
+    return false;
+
+  evt = {};
+  evt.type = type;
+  evt.common.timestamp = timestamp;
+
+  switch (evt.type) {
+    case SDL_EVENT_KEY_DOWN:
+    case SDL_EVENT_KEY_UP: {
+      uint32_t scancode = 0;
+      ok &= SDL_ReadU32LE(io, &evt.key.which);
+      ok &= SDL_ReadU32LE(io, &scancode);
+      ok &= SDL_ReadU32LE(io, &evt.key.key);
+      ok &= SDL_ReadU16LE(io, &evt.key.mod);
+      ok &= SDL_ReadU16LE(io, &evt.key.raw);
+      ok &= SDL_ReadU8(io, &down);
+      ok &= SDL_ReadU8(io, &repeat);
+      evt.key.scancode = (SDL_Scancode)scancode;
+      evt.key.down = down != 0;
+      evt.key.repeat = repeat != 0;
+      return ok;
+    }
+    case SDL_EVENT_MOUSE_BUTTON_DOWN:
+    case SDL_EVENT_MOUSE_BUTTON_UP:
+      ok &= SDL_ReadU32LE(io, &evt.button.which);
+      ok &= SDL_ReadU8(io, &evt.button.button);
+      ok &= SDL_ReadU8(io, &down);
+      ok &= SDL_ReadU8(io, &evt.button.clicks);
+      ok &= read_f32(io, evt.button.x);
+      ok &= read_f32(io, evt.button.y);
+      evt.button.down = down != 0;
+      return ok;
+    case SDL_EVENT_JOYSTICK_ADDED:
+    case SDL_EVENT_JOYSTICK_REMOVED:
+      return SDL_ReadU32LE(io, &evt.jdevice.which);
+    case SDL_EVENT_GAMEPAD_ADDED:
+    case SDL_EVENT_GAMEPAD_REMOVED:
+      return SDL_ReadU32LE(io, &evt.gdevice.which);
+    case SDL_EVENT_JOYSTICK_BUTTON_DOWN:
+    case SDL_EVENT_JOYSTICK_BUTTON_UP:
+      ok &= SDL_ReadU32LE(io, &evt.jbutton.which);
+      ok &= SDL_ReadU8(io, &evt.jbutton.button);
+      ok &= SDL_ReadU8(io, &down);
+      evt.jbutton.down = down != 0;
+      return ok;
+    case SDL_EVENT_GAMEPAD_BUTTON_DOWN:
+    case SDL_EVENT_GAMEPAD_BUTTON_UP:
+      ok &= SDL_ReadU32LE(io, &evt.gbutton.which);
+      ok &= SDL_ReadU8(io, &evt.gbutton.button);
+      ok &= SDL_ReadU8(io, &down);
+      evt.gbutton.down = down != 0;
+      return ok;
+    case SDL_EVENT_JOYSTICK_AXIS_MOTION:
+      ok &= SDL_ReadU32LE(io, &evt.jaxis.which);
+      ok &= SDL_ReadU8(io, &evt.jaxis.axis);
+      ok &= SDL_ReadS16LE(io, &evt.jaxis.value);
+      return ok;
+    case SDL_EVENT_GAMEPAD_AXIS_MOTION:
+      ok &= SDL_ReadU32LE(io, &evt.gaxis.which);
+      ok &= SDL_ReadU8(io, &evt.gaxis.axis);
+      ok &= SDL_ReadS16LE(io, &evt.gaxis.value);
+      return ok;
+    default:
+      return false;
+  }
+};
+
+void
+append_connected_devices(std::vector<SDL_Event>& events)
+{
+  int n = 0;
+  SDL_JoystickID* ids = SDL_GetJoysticks(&n);
+  for (int i = 0; i < n; i++) {
+    SDL_Event evt{};
+    evt.type = SDL_EVENT_JOYSTICK_ADDED;
+    evt.jdevice.which = ids[i];
+    events.push_back(evt);
+
+    if (SDL_IsGamepad(ids[i])) {
+      evt = {};
+      evt.type = SDL_EVENT_GAMEPAD_ADDED;
+      evt.gdevice.which = ids[i];
+      events.push_back(evt);
+    }
+  }
+  SDL_free(ids);
+};
+
+void
+open_replay_writer(ReplayWriter& writer, const std::string& path, const ReplayHeader& header)
+{
+  writer.io = SDL_IOFromFile(path.c_str(), "wb");
+  if (writer.io == nullptr)
+    throw SDLException("Failed to open replay for writing: " + path);
+  writer.n_ticks = 0;
+
+  bool ok = true;
+  ok &= SDL_WriteU32LE(writer.io, REPLAY_MAGIC);
+  ok &= SDL_WriteU32LE(writer.io, REPLAY_VERSION);
+  ok &= SDL_WriteU32LE(writer.io, header.seed);
+  ok &= SDL_WriteU64LE(writer.io, header.ns_per_fixed_tick);
+  if (!ok)
+    throw SDLException("Failed to write replay header");
+};
+
+void
+write_replay_tick(ReplayWriter& writer, const ReplayTick& tick)
+{
+  // the count comes first, so the ones that are skipped need counting
+  uint32_t n_events = 0;
+  for (const SDL_Event& evt : tick.events)
+    n_events += is_replay_event(evt) ? 1 : 0;
+
+  bool ok = true;
+  ok &= SDL_WriteU64LE(writer.io, tick.dt_ns);
+  ok &= SDL_WriteU64LE(writer.io, tick.fixed_tick);
+  ok &= SDL_WriteU32LE(writer.io, tick.n_fixed);
+  ok &= SDL_WriteU64LE(writer.io, tick.ns_per_fixed_tick);
+  ok &= write_f32(writer.io, tick.mouse_pos.x);
+  ok &= write_f32(writer.io, tick.mouse_pos.y);
+  ok &= SDL_WriteU8(writer.io, tick.play_again ? 1 : 0);
+  ok &= SDL_WriteU32LE(writer.io, n_events);
+  for (const SDL_Event& evt : tick.events) {
+    if (is_replay_event(evt))
+      ok &= write_replay_event(writer.io, evt);
+  }
+  if (!ok)
+    throw SDLException("Failed to write replay tick");
+
+  writer.n_ticks++;
+};
+
+void
+close_replay_writer(ReplayWriter& writer)
+{
+  if (writer.io == nullptr)
+    return;
+  SDL_Log("(Replay) wrote %llu ticks", (unsigned long long)writer.n_ticks);
+  SDL_CloseIO(writer.io);
+  writer.io = nullptr;
+};
+
+void
+open_replay_reader(ReplayReader& reader, const std::string& path)
+{
+  reader.io = SDL_IOFromFile(path.c_str(), "rb");
+  if (reader.io == nullptr)
+    throw SDLException("Failed to open replay for reading: " + path);
+  reader.n_ticks = 0;
+
+  uint32_t magic = 0;
+  uint32_t version = 0;
+  bool ok = true;
+  ok &= SDL_ReadU32LE(reader.io, &magic);
+  ok &= SDL_ReadU32LE(reader.io, &version);
+  ok &= SDL_ReadU32LE(reader.io, &reader.header.seed);
+  ok &= SDL_ReadU64LE(reader.io, &reader.header.ns_per_fixed_tick);
+  if (!ok)
+    throw SDLException("Failed to read replay header: " + path);
+
+  if (magic != REPLAY_MAGIC)
+    throw std::runtime_error("Not a replay file: " + path);
+  if (version != REPLAY_VERSION)
+    throw std::runtime_error("Unsupported replay version: " + std::to_string(version));
+};
+
+bool
+read_replay_tick(ReplayReader& reader, ReplayTick& tick)
+{
+  // a clean end of file fails on the first read
+  if (!SDL_ReadU64LE(reader.io, &tick.dt_ns))
+    return false;
+
+  uint8_t play_again = 0;
+  uint32_t n_events = 0;
+  bool ok = true;
+  ok &= SDL_ReadU64LE(reader.io, &tick.fixed_tick);
+  ok &= SDL_ReadU32LE(reader.io, &tick.n_fixed);
+  ok &= SDL_ReadU64LE(reader.io, &tick.ns_per_fixed_tick);
+  ok &= read_f32(reader.io, tick.mouse_pos.x);
+  ok &= read_f32(reader.io, tick.mouse_pos.y);
+  ok &= SDL_ReadU8(reader.io, &play_again);
+  ok &= SDL_ReadU32LE(reader.io, &n_events);
+  if (!ok) {
+    SDL_Log("(Replay) truncated tick %llu", (unsigned long long)reader.n_ticks);
+    return false;
+  }
+  tick.play_again = play_again != 0;
+
+  tick.events.resize(n_events);
+  for (SDL_Event& evt : tick.events) {
+    if (!read_replay_event(reader.io, evt)) {
+      SDL_Log("(Replay) truncated or unknown event in tick %llu", (unsigned long long)reader.n_ticks);
+      return false;
+    }
+  }
+
+  reader.n_ticks++;
+  return true;
+};
+
+void
+close_replay_reader(ReplayReader& reader)
+{
+  if (reader.io == nullptr)
+    return;
+  SDL_CloseIO(reader.io);
+  reader.io = nullptr;
+};
+
+} // namespace game2d
@@ -0,0 +1,85 @@
+#pragma once
+
+#include "core/common.hpp"
+
+#include <SDL3/SDL.h>
+
+#include <string>
+#include <vector>
+
+//
+// Records the inputs of every GameThread tick to a binary file,
+// so the same workload can be replayed later at uncapped speed.
+//
+// layout (little endian):
+//   header: magic, version, seed, ns_per_fixed_tick
+//   ticks:  dt_ns, fixed_tick, n_fixed, ns_per_fixed_tick, mouse_x, mouse_y, play_again, n_events, events[n_events]
+//   events: type, timestamp, which, then the fields the game reads for that type
+//
+// SDL_Event is never written whole, so a replay does not depend on its layout.
+//
+
+namespace game2d {
+
+constexpr uint32_t REPLAY_MAGIC = 0x594C5052; // "RPLY"
+constexpr uint32_t REPLAY_VERSION = 4;
+
+struct ReplayHeader
+{
+  uint32_t seed = 0;
+  uint64_t ns_per_fixed_tick = 0;
+};
+
+struct ReplayTick
+{
+  uint64_t dt_ns = 0;
+  uint64_t fixed_tick = 0; // index of the first fixed step this tick
+  uint32_t n_fixed = 0;    // fixed steps run this tick
+  uint64_t ns_per_fixed_tick = 0;
+  vec2 mouse_pos{ 0, 0 };
+  bool play_again = false;
+  std::vector<SDL_Event> events;
+};
+
+struct ReplayWriter
+{
+  SDL_IOStream* io = nullptr;
+  uint64_t n_ticks = 0;
+};
+
+struct ReplayReader
+{
+  SDL_IOStream* io = nullptr;
+  ReplayHeader header;
+  uint64_t n_ticks = 0;
+};
+
+// events the game does not read (mouse motion, window events) are not written
+bool
+is_replay_event(const SDL_Event& evt);
+
+// an added event for each device that is already connected.
+// the replay opens nothing, it learns the devices from these
+void
+append_connected_devices(std::vector<SDL_Event>& events);
+
+void
+open_replay_writer(ReplayWriter& writer, const std::string& path, const ReplayHeader& header);
+
+void
+write_replay_tick(ReplayWriter& writer, const ReplayTick& tick);
+
+void
+close_replay_writer(ReplayWriter& writer);
+
+void
+open_replay_reader(ReplayReader& reader, const std::string& path);
+
+// returns false at the end of the file
+bool
+read_replay_tick(ReplayReader& reader, ReplayTick& tick);
+
+void
+close_replay_reader(ReplayReader& reader);
+
+} // namespace game2d
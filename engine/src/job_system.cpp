@@ -0,0 +1,64 @@
+#include "core/pch.hpp"
+
+#include "job_system.hpp"
+
+#include <memory>
+
+namespace game2d {
+
+class JobTask : public enki::ITaskSet
+{
+public:
+  JobTask() = default;
+
+  void ExecuteRange(enki::TaskSetPartition range, uint32_t threadIndex) override
+  {
+    m_fn(range.start, range.end, threadIndex, m_user);
+  }
+
+  job_range_func_t* m_fn = nullptr;
+  void* m_user = nullptr;
+};
+
+// finished tasks, reused by the next enqueue on the same thread.
+// jobs can be enqueued from any worker, so there is no lock
+static thread_local std::vector<std::unique_ptr<JobTask>> free_tasks;
+
+static void*
+enqueue_job(job_range_func_t* fn, uint32_t n, uint32_t min_range, void* user, void* ctx)
+{
+  auto* scheduler = static_cast<enki::TaskScheduler*>(ctx);
+
+  JobTask* task = nullptr;
+  if (free_tasks.empty())
+    task = new JobTask();
+  else {
+    task = free_tasks.back().release();
+    free_tasks.pop_back();
+  }
+  task->m_SetSize = n;
+  task->m_MinRange = min_range;
+  task->m_fn = fn;
+  task->m_user = user;
+  scheduler->AddTaskSetToPipe(task);
+  return task;
+};
+
+static void
+finish_job(void* job, void* ctx)
+{
+  auto* scheduler = static_cast<enki::TaskScheduler*>(ctx);
+  auto* task = static_cast<JobTask*>(job);
+  scheduler->WaitforTask(task);
+  free_tasks.emplace_back(task);
+};
+
+void
+init_job_system(JobSystem& jobs, enki::TaskScheduler& scheduler)
+{
+  jobs.enqueue = enqueue_job;
+  jobs.finish = finish_job;
+  jobs.ctx = &scheduler;
+};
+
+} // namespace game2d
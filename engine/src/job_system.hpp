@@ -0,0 +1,14 @@
+#pragma once
+
+#include "core/common.hpp"
+
+#include "TaskScheduler.h"
+
+namespace game2d {
+
+// Backs the game's JobSystem with the engine's enkiTS scheduler.
+// The scheduler must be initialized on the thread that runs the game.
+void
+init_job_system(JobSystem& jobs, enki::TaskScheduler& scheduler);
+
+} // namespace game2d
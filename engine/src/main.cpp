@@ -2,7 +2,14 @@
 
 // #include "box2d_parallel.hpp"
 #include "core/common.hpp"
+#include "core/events/event_bus.hpp"
 #include "core/maths/mat.hpp"
+#include "core/particles/particles.hpp"
+#include "core/physics/physics_pipeline.hpp"
+#include "core/render/renderables.hpp"
+#include "fixed_step_scheduler.hpp"
+#include "input_replay.hpp"
+#include "job_system.hpp"
 #include "sdl_exception.hpp"
 #include "sdl_hot_reload_dll.hpp"
 #include "sdl_shader.hpp"
@@ -61,10 +68,20 @@ void SwapBuffers() {current_read_buffer.store(1 - current_read_buffer.load(), st
 
 // data owned by game thread
 GameData game_data;
+PhysicsPipeline physics_pipeline;
+enki::TaskScheduler task_scheduler;
+JobSystem job_system;
+EventBus event_bus;
+FrameArena game_arena; // transient allocations for one gamethread tick
+InputLatencySample tick_latency; // the oldest input this tick uses, if any
+MemoryTracker memory_tracker; // box2d, entt and imgui allocations. never destroyed before them
+Logger logger; // records from every thread, written by the log thread
 
 // data owned by ui thread
 std::mutex game_ui_mtx;
 GameUIData game_ui_data;
+FrameArena render_arena; // transient allocations for one renderthread frame
+InputLatencyTracker input_latency;
 
 std::mutex rebuild_dll_mtx;
 sdl_game_code game_code;
@@ -83,6 +100,127 @@ const auto calc_dt_ns = [](Uint64 now, Uint64& past) -> Uint64 {
   return dt_ns;
 };
 
+// runs the fixed updates. rate and catch-up are set from the command line or ui
+static FixedStepScheduler fixed_step;
+
+// input record/replay, set from the command line
+static std::string record_path;
+static std::string replay_path;
+static std::string timings_path;
+
+// events that the game turns in to actions. motion is left out,
+// the mouse position is read once per frame instead.
+static bool
+is_input_event(const SDL_Event& evt)
+{
+  switch (evt.type) {
+    case SDL_EVENT_KEY_DOWN:
+    case SDL_EVENT_KEY_UP:
+    case SDL_EVENT_MOUSE_BUTTON_DOWN:
+    case SDL_EVENT_MOUSE_BUTTON_UP:
+    case SDL_EVENT_GAMEPAD_BUTTON_DOWN:
+    case SDL_EVENT_GAMEPAD_BUTTON_UP:
+    case SDL_EVENT_GAMEPAD_AXIS_MOTION:
+    case SDL_EVENT_JOYSTICK_AXIS_MOTION:
+      return true;
+    default:
+      return false;
+  }
+};
+
+// box2d's allocator has no user data, so it uses the global tracker
+static void*
+b2_tracked_alloc(unsigned int size, int alignment)
+{
+  return tracked_alloc(&memory_tracker, MemoryTag::PHYSICS, size, (size_t)alignment);
+};
+
+static void
+b2_tracked_free(void* p)
+{
+  tracked_free(p);
+};
+
+// made here so the last copy can be released after a reload
+static std::shared_ptr<const std::vector<UIEntity>>
+make_ui_snapshot(std::span<const UIEntity> entries)
+{
+  return std::make_shared<const std::vector<UIEntity>>(entries.begin(), entries.end());
+};
+
+const auto get_system_time_for_seed = []() -> int {
+  auto now = std::chrono::high_resolution_clock::now();
+  long long seed = std::chrono::duration_cast<std::chrono::nanoseconds>(now.time_since_epoch()).count();
+  return (int)seed;
+};
+
+// everything the gamethread does once its inputs for the tick are set
+void
+GameTick(const float dt, const Uint32 n_fixed)
+{
+  reset_frame_arena(game_arena);
+  begin_event_frame(event_bus);
+
+  // FixedUpdate()
+  game_data.fixed_dt = get_fixed_dt(fixed_step);
+  for (Uint32 i = 0; i < n_fixed; i++) {
+    std::scoped_lock<std::mutex> lock(rebuild_dll_mtx);
+    if (game_code.valid) {
+      ZoneScopedN("(GameThread) game_fixed_update()");
+      const Uint64 start = SDL_GetTicksNS();
+      game_code.game_fixed_update(&game_data);
+      record_fixed_tick(fixed_step, SDL_GetTicksNS() - start);
+    }
+  }
+
+  // GameUpdate()
+  {
+    ZoneScopedN("(GameThread) game_update()");
+    std::scoped_lock<std::mutex> lock(rebuild_dll_mtx);
+    if (game_code.valid)
+      game_code.game_update(&game_data);
+  }
+  if (tick_latency.valid)
+    stamp_latency(tick_latency, LatencyStage::SIMULATE, SDL_GetTicksNS());
+
+  // Ding ding! frame done. Update RenderData
+  RenderData& wb = GetWriteBuffer();
+  {
+    ZoneScopedN("(GameThread) game_update_write()");
+    std::scoped_lock<std::mutex> lock0(wb.mtx);
+
+    // copy transforms in to RenderData. linear over the owning group.
+    extract_renderables(*game_data.r, wb.renderable);
+
+    // particles are packed straight in to sprite instances.
+    if (game_data.particles)
+      pack_particles(*game_data.particles, wb.particles);
+    else
+      wb.particles.clear();
+
+    // copy anything else in to renderdata buffer.
+    wb.camera_pos = game_data.camera_pos;
+    wb.camera_velocity = game_data.camera_velocity;
+    wb.camera_ns = SDL_GetTicksNS();
+    wb.ui_data = game_data.ui_data;
+    wb.ui_data.game_dt = dt;
+    wb.ui_data.fixed_step = fixed_step.stats;
+    export_event_stats(event_bus, wb.ui_data.events);
+    export_memory_stats(memory_tracker, wb.ui_data.memory);
+    wb.ui_data.game_arena = get_frame_arena_stats(game_arena);
+
+    // if the renderthread never took the last sample from this buffer,
+    // that frame was not shown. this one shows both inputs, keep the older.
+    if (tick_latency.valid) {
+      stamp_latency(tick_latency, LatencyStage::EXTRACT, wb.camera_ns);
+      merge_latency_samples(wb.latency, tick_latency);
+      tick_latency.valid = false;
+    }
+  }
+
+  SwapBuffers();
+};
+
 void
 GameThread()
 {
@@ -108,10 +246,32 @@ GameThread()
   // s->m_scheduler.Initialize(worker_count);
   // s->m_taskCount = 0;
 
+  // the gamethread is enki's main thread, other threads are workers.
+  // leave cores for the main, render and physics threads.
+  const int n_job_threads = std::max(2, logical_cpu_cores - (physics_pipeline.pipelined ? 3 : 2));
+  task_scheduler.Initialize(n_job_threads);
+  init_job_system(job_system, task_scheduler);
+  game_data.jobs = &job_system;
+  SDL_Log("(GameThread) job threads: %i", n_job_threads);
+
+  // steps the world on its own thread when pipelined
+  game_data.physics = &physics_pipeline;
+  if (physics_pipeline.pipelined)
+    start_physics_pipeline(physics_pipeline);
+  SDL_Log("(GameThread) physics: %s", physics_pipeline.pipelined ? "pipelined" : "sequential");
+
   //  game init after physics init
-  // entt::registry r;
+  // Registry r;
   game_code.game_init(&game_data);
 
+  ReplayWriter recorder;
+  if (!record_path.empty()) {
+    open_replay_writer(recorder, record_path, { .seed = (uint32_t)game_data.seed, .ns_per_fixed_tick = fixed_step.ns_per_tick });
+    SDL_Log("(GameThread) recording inputs to %s", record_path.c_str());
+  }
+  ReplayTick tick;
+  Uint64 fixed_tick = 0;
+
   SDL_Log("(GameThread) -- done init");
   tracy::SetThreadName("GameThread");
 
@@ -129,11 +289,32 @@ GameThread()
       std::scoped_lock<std::mutex> lock(game_ui_mtx);
       game_data.ui_data = game_ui_data.ui_data;
     }
+    if (game_data.ui_data.requested_tick_hz > 0.0f) {
+      set_tick_rate(fixed_step, game_data.ui_data.requested_tick_hz);
+      game_data.ui_data.requested_tick_hz = 0.0f;
+      SDL_Log("(GameThread) fixed tick rate: %0.2f", fixed_step.stats.tick_hz);
+    }
 
     // pop all the events at once from a thread-safe buffer.
     {
-      game_data.events = event_queue.dequeue_all();
+      Uint64 poll_ns = 0;
+      event_queue.dequeue_all(game_data.events, &poll_ns);
       game_data.mouse_pos = mouse_pos;
+
+      // follow the oldest input through to the screen
+      tick_latency = {};
+      for (const SDL_Event& evt : game_data.events) {
+        if (!is_input_event(evt))
+          continue;
+        const Uint64 event_ns = evt.common.timestamp;
+        if (!tick_latency.valid || event_ns < tick_latency.ns[(size_t)LatencyStage::EVENT])
+          stamp_latency(tick_latency, LatencyStage::EVENT, event_ns);
+        tick_latency.valid = true;
+      }
+      if (tick_latency.valid) {
+        stamp_latency(tick_latency, LatencyStage::POLL, poll_ns);
+        stamp_latency(tick_latency, LatencyStage::DEQUEUE, SDL_GetTicksNS());
+      }
     }
 
     // Check for rebuild
@@ -148,65 +329,117 @@ GameThread()
     }
 
     // run physics at fixed timesteps
-    static Uint64 accu = 0;
-    constexpr int physics_substep_count = 4;
-    constexpr float physics_dt = 1.0f / 60.0f;
-    constexpr Uint64 NS_PER_FIXED_TICK = (Uint64)(1e9 / 60.0);
-    accu += dt_ns;
-    while (accu >= NS_PER_FIXED_TICK) {
-      accu -= NS_PER_FIXED_TICK;
-
-      // FixedUpdate()
-      {
-        std::scoped_lock<std::mutex> lock(rebuild_dll_mtx);
-        if (game_code.valid) {
-          ZoneScopedN("(GameThread) game_fixed_update()");
-          game_code.game_fixed_update(&game_data);
-        }
-      }
-
-      // b2World_Step(game_data.world_id, physics_dt, physics_substep_count);
-      // s->m_taskCount = 0;
+    const Uint32 n_fixed = advance_fixed_steps(fixed_step, dt_ns);
+
+    if (recorder.io) {
+      tick.events.clear();
+      if (recorder.n_ticks == 0)
+        append_connected_devices(tick.events);
+      tick.events.insert(tick.events.end(), game_data.events.begin(), game_data.events.end());
+      tick.dt_ns = dt_ns;
+      tick.fixed_tick = fixed_tick;
+      tick.n_fixed = n_fixed;
+      tick.ns_per_fixed_tick = fixed_step.ns_per_tick;
+      tick.mouse_pos = game_data.mouse_pos;
+      tick.play_again = game_data.ui_data.play_again;
+      write_replay_tick(recorder, tick);
     }
+    fixed_tick += n_fixed;
 
-    // GameUpdate()
-    {
-      ZoneScopedN("(GameThread) game_update()");
-      std::scoped_lock<std::mutex> lock(rebuild_dll_mtx);
-      if (game_code.valid)
-        game_code.game_update(&game_data);
-    }
-
-    // Ding ding! frame done. Update RenderData
-    RenderData& wb = GetWriteBuffer();
-    {
-      ZoneScopedN("(GameThread) game_update_write()");
-      std::scoped_lock<std::mutex> lock0(wb.mtx);
-
-      // should do something better than .clear()
-      wb.renderable.clear();
-      wb.ui_data.hmm.clear();
-
-      // copy transforms in to RenderData.
-      const auto view = game_data.r->view<const TransformComponent, const ColourComponent>();
-      view.each([&](entt::entity e, const auto& t_c, const auto& col_c) {
-        wb.renderable.push_back(Renderable{
-          .transform = t_c,
-          .colour = col_c,
-        });
-      });
-
-      // copy anything else in to renderdata buffer.
-      wb.camera_pos = game_data.camera_pos;
-      wb.ui_data = game_data.ui_data;
-      wb.ui_data.game_dt = dt;
-    }
-
-    SwapBuffers();
+    GameTick(dt, n_fixed);
     FrameMark; // frame done
   }
 
+  close_replay_writer(recorder);
+  stop_physics_pipeline(physics_pipeline);
   b2DestroyWorld(game_data.world_id);
+  task_scheduler.WaitforAllAndShutdown();
+};
+
+// Replays a recording without a window, as fast as possible.
+// The recorded dt and number of fixed steps are used instead of the clock.
+int
+RunReplay()
+{
+  ReplayReader reader;
+  open_replay_reader(reader, replay_path);
+  set_tick_ns(fixed_step, reader.header.ns_per_fixed_tick);
+
+  game_data.seed = (int)reader.header.seed;
+  game_data.replaying = true;
+  task_scheduler.Initialize(std::max(2, SDL_GetNumLogicalCPUCores() - 1));
+  init_job_system(job_system, task_scheduler);
+  game_data.jobs = &job_system;
+  game_data.physics = &physics_pipeline;
+  if (physics_pipeline.pipelined)
+    start_physics_pipeline(physics_pipeline);
+  game_code.game_init(&game_data);
+
+  std::vector<Uint64> tick_ns;
+  ReplayTick tick;
+  Uint64 fixed_tick = 0;
+  const Uint64 freq = SDL_GetPerformanceFrequency();
+
+  while (read_replay_tick(reader, tick)) {
+    if (tick.fixed_tick != fixed_tick)
+      SDL_Log("(Replay) warning: fixed tick mismatch at %llu", (unsigned long long)reader.n_ticks);
+    fixed_tick = tick.fixed_tick + tick.n_fixed;
+    if (tick.ns_per_fixed_tick != fixed_step.ns_per_tick)
+      set_tick_ns(fixed_step, tick.ns_per_fixed_tick);
+
+    const float dt = (float)(1e-9 * (float)tick.dt_ns);
+    game_data.dt = dt;
+    game_data.events = tick.events;
+    game_data.mouse_pos = tick.mouse_pos;
+    game_data.ui_data.play_again = tick.play_again;
+
+    const Uint64 start = SDL_GetPerformanceCounter();
+    GameTick(dt, tick.n_fixed);
+    const Uint64 end = SDL_GetPerformanceCounter();
+    tick_ns.push_back((end - start) * 1'000'000'000 / freq);
+    FrameMark;
+  }
+  close_replay_reader(reader);
+  stop_physics_pipeline(physics_pipeline);
+  b2DestroyWorld(game_data.world_id);
+  task_scheduler.WaitforAllAndShutdown();
+
+  if (tick_ns.empty()) {
+    SDL_Log("(Replay) no ticks in %s", replay_path.c_str());
+    return SDL_APP_FAILURE;
+  }
+
+  if (!timings_path.empty()) {
+    SDL_IOStream* io = SDL_IOFromFile(timings_path.c_str(), "w");
+    if (io == nullptr)
+      throw SDLException("Failed to open timings file: " + timings_path);
+    SDL_IOprintf(io, "tick,ns\n");
+    for (size_t i = 0; i < tick_ns.size(); i++)
+      SDL_IOprintf(io, "%zu,%llu\n", i, (unsigned long long)tick_ns[i]);
+    SDL_CloseIO(io);
+  }
+
+  Uint64 total_ns = 0;
+  for (const Uint64 ns : tick_ns)
+    total_ns += ns;
+  std::vector<Uint64> sorted = tick_ns;
+  std::sort(sorted.begin(), sorted.end());
+  const auto percentile = [&sorted](const double p) -> double {
+    const size_t i = std::min(sorted.size() - 1, (size_t)(p * (double)sorted.size()));
+    return (double)sorted[i] * 1e-6;
+  };
+
+  SDL_Log("(Replay) ticks: %zu fixed ticks: %llu total: %0.2fms",
+          tick_ns.size(),
+          (unsigned long long)fixed_tick,
+          (double)total_ns * 1e-6);
+  SDL_Log("(Replay) per tick ms. mean: %0.4f p50: %0.4f p95: %0.4f p99: %0.4f max: %0.4f",
+          (double)total_ns * 1e-6 / (double)tick_ns.size(),
+          percentile(0.50),
+          percentile(0.95),
+          percentile(0.99),
+          (double)sorted.back() * 1e-6);
+  return 0;
 };
 
 // Vertex Formats
@@ -257,15 +490,6 @@ const std::vector<Index> index_data{
 
 */
 
-typedef struct SpriteInstance
-{
-  float x, y, z;
-  float rotation;
-  float w, h, p1, p2;
-  float tex_u, tex_v, tex_w, tex_h;
-  float colour[4];
-} SpriteInstance;
-
 void
 RenderThread()
 {
@@ -274,7 +498,7 @@ RenderThread()
 
   game2d::InitializeAssetLoader();
 
-  const uint32_t SPRITE_COUNT = 8192;
+  const uint32_t SPRITE_COUNT = 8192 + MAX_PARTICLES;
   const Matrix4x4 camera_proj = Matrix4x4_CreateOrthographicOffCenter(0, 1280, 720, 0, 0, -1);
 
   SDL_GPUPresentMode present_mode = SDL_GPU_PRESENTMODE_VSYNC;
@@ -585,22 +809,39 @@ RenderThread()
     static Uint64 renderer_past = 0;
     const Uint64 now = SDL_GetTicksNS();
     const Uint64 dt_ns = calc_dt_ns(now, renderer_past);
+    reset_frame_arena(render_arena);
 
     // handoff: game thread pusning data in to gameuidata
     // note: this doubles the memory,
     // because its copying the entire RenderData
     auto& read_buffer = GetReadBuffer();
+    InputLatencySample latency;
+    vec2 camera_velocity{ 0, 0 };
+    Uint64 camera_ns = 0;
+    Uint32 n_renderables = 0;
+    Uint32 n_particles = 0;
+    SpriteInstance* data_ptr = (SpriteInstance*)SDL_MapGPUTransferBuffer(device, sprite_data_transfer_buffer, true);
     {
       ZoneScopedN("(RenderThread) read_buffer_copy");
       std::scoped_lock<std::mutex> lock0(read_buffer.mtx);
       std::scoped_lock<std::mutex> lock1(game_ui_mtx);
 
-      game_ui_data.renderable = read_buffer.renderable; // take a copy
-      game_ui_data.ui_data = read_buffer.ui_data;
-      game_ui_data.camera_pos = read_buffer.camera_pos;
+      copy_render_data(read_buffer, game_ui_data);
+      game_ui_data.ui_data.render_arena = get_frame_arena_stats(render_arena);
+      game_ui_data.ui_data.input_latency = get_input_latency_stats(input_latency);
+      camera_velocity = read_buffer.camera_velocity;
+      camera_ns = read_buffer.camera_ns;
+
+      // only the first frame to show an input measures it
+      latency = read_buffer.latency;
+      read_buffer.latency.valid = false;
+
+      // particles go in to the transfer buffer, after the renderables
+      n_renderables = std::min((Uint32)read_buffer.renderable.size(), SPRITE_COUNT);
+      n_particles = copy_particle_instances(read_buffer, data_ptr + n_renderables, SPRITE_COUNT - n_renderables);
     }
     const auto& renderables = game_ui_data.renderable;
-    const Matrix4x4 camera_view = Matrix4x4_CreateView(game_ui_data.camera_pos);
+    const Uint32 n_sprites = n_renderables + n_particles;
 
     // Start the Dear ImGui frame
     ImGui_ImplSDLGPU3_NewFrame();
@@ -632,46 +873,22 @@ RenderThread()
       SDL_GPUTexture* swapchain_texture;
       SDL_WaitAndAcquireGPUSwapchainTexture(cmd_buf, window, &swapchain_texture, nullptr, nullptr);
 
-      if (swapchain_texture != nullptr && !is_minimized) {
+      vec2 camera_pos = game_ui_data.camera_pos;
+      const bool drawn = swapchain_texture != nullptr && !is_minimized;
+      if (drawn) {
         // This is mandatory: call Imgui_ImplSDLGPU3_PrepareDrawData() to upload the vertex/index buffer!
         Imgui_ImplSDLGPU3_PrepareDrawData(draw_data, cmd_buf);
 
-        // Build sprite instance transfer
-        SpriteInstance* data_ptr = (SpriteInstance*)SDL_MapGPUTransferBuffer(device, sprite_data_transfer_buffer, true);
-        for (Uint32 i = 0; i < SPRITE_COUNT; i += 1) {
-
-          data_ptr[i].x = 0.0f;
-          data_ptr[i].y = 0.0f;
-          data_ptr[i].z = 0.0f;
-          data_ptr[i].rotation = 0.0f;
-          data_ptr[i].w = 0.0f;
-          data_ptr[i].h = 0.0f;
-
-          if (i < renderables.size()) {
-            const auto& transform = renderables[i].transform;
-            data_ptr[i].x = transform.pos.x;
-            data_ptr[i].y = transform.pos.y;
-            data_ptr[i].z = 0.0f;
-            data_ptr[i].rotation = transform.rotation_radians;
-            data_ptr[i].w = transform.size.x;
-            data_ptr[i].h = transform.size.y;
-          }
-
-          data_ptr[i].p1 = 0.0f;
-          data_ptr[i].p2 = 0.0f;
-          data_ptr[i].tex_u = 0.0f;
-          data_ptr[i].tex_v = 0.0f;
-          data_ptr[i].tex_w = 1.0f;
-          data_ptr[i].tex_h = 1.0f;
-
-          if (i < renderables.size()) {
-            const auto& colour = renderables[i].colour;
-            data_ptr[i].colour[0] = colour.r;
-            data_ptr[i].colour[1] = colour.g;
-            data_ptr[i].colour[2] = colour.b;
-            data_ptr[i].colour[3] = colour.a;
-          }
+        // late camera: apply the newest camera input as late as possible.
+        // capped, so a stalled gamethread doesnt fling the camera away
+        const Uint64 pack_ns = SDL_GetTicksNS();
+        if (game_ui_data.late_camera && camera_ns != 0 && pack_ns > camera_ns) {
+          const float ahead = std::min((float)(1e-9 * (double)(pack_ns - camera_ns)), 0.1f);
+          camera_pos = camera_pos + ahead * camera_velocity;
         }
+
+        // Build sprite instance transfer. the particles are already in
+        pack_sprite_instances({ renderables.data(), n_renderables }, data_ptr);
         SDL_UnmapGPUTransferBuffer(device, sprite_data_transfer_buffer);
 
         // Upload instance data.
@@ -684,7 +901,7 @@ RenderThread()
           const auto gpu_buffer_region_loc = SDL_GPUBufferRegion{
             .buffer = sprite_data_buffer,
             .offset = 0,
-            .size = SPRITE_COUNT * sizeof(SpriteInstance),
+            .size = std::max(n_sprites, 1u) * (Uint32)sizeof(SpriteInstance),
           };
           SDL_UploadToGPUBuffer(copy_pass, &transfer_buffer_loc, &gpu_buffer_region_loc, true);
         }
@@ -720,21 +937,30 @@ RenderThread()
         const SDL_GPUTextureSamplerBinding tex_sampler_binding = { .texture = Texture, .sampler = sampler };
         SDL_BindGPUFragmentSamplers(render_pass, 0, &tex_sampler_binding, 1);
 
+        const Matrix4x4 camera_view = Matrix4x4_CreateView(camera_pos);
         const auto view_projection = camera_view * camera_proj;
         SDL_PushGPUVertexUniformData(cmd_buf, 0, &view_projection, sizeof(Matrix4x4));
 
-        SDL_DrawGPUPrimitives(render_pass, SPRITE_COUNT * 6, 1, 0, 0);
+        if (n_sprites > 0)
+          SDL_DrawGPUPrimitives(render_pass, n_sprites * 6, 1, 0, 0);
         // SDL_DrawGPUIndexedPrimitives(render_pass, index_data.size(), 1, 0, 0, 0);
 
         // Render ImGui
         ImGui_ImplSDLGPU3_RenderDrawData(draw_data, cmd_buf, render_pass);
 
         SDL_EndGPURenderPass(render_pass);
-      }
+      } else
+        SDL_UnmapGPUTransferBuffer(device, sprite_data_transfer_buffer);
 
       const auto submit = SDL_SubmitGPUCommandBuffer(cmd_buf);
       if (!submit)
         throw SDLException("Could not SDL_SubmitGPUCommandBuffer()");
+
+      // the gpu's present time isnt exposed, submit is the last stage measured
+      if (latency.valid && drawn) {
+        stamp_latency(latency, LatencyStage::SUBMIT, SDL_GetTicksNS());
+        record_latency_sample(input_latency, latency);
+      }
     }
 
     FrameMark; // frame done
@@ -787,29 +1013,101 @@ main(int argc, char* argv[])
   SDL_Log("You have %i logical cpu cores", SDL_GetNumLogicalCPUCores());
   SDL_Log("(main()) SDL_IsMainThread(): %i", SDL_IsMainThread());
 
+  // --record <file>: write the inputs of each tick
+  // --replay <file> [--timings <file.csv>]: replay them headless, uncapped
+  // --pipelined-physics: step the world on a physics thread, one tick behind gameplay
+  // --tick-rate <hz>, --max-catchup <steps>: fixed update rate, and max fixed updates per frame
+  // --memory-budget <physics|registry|imgui> <mb>: log and count allocations over the budget
+  // --late-camera: the renderthread moves the camera on from the gamethread's last input, just before drawing
+  set_memory_budget(memory_tracker, MemoryTag::PHYSICS, 256ull << 20);
+  set_memory_budget(memory_tracker, MemoryTag::REGISTRY, 128ull << 20);
+  set_memory_budget(memory_tracker, MemoryTag::IMGUI, 16ull << 20);
+  for (int i = 1; i < argc; i++) {
+    const std::string_view arg = argv[i];
+    const bool has_value = i + 1 < argc;
+    if (arg == "--record" && has_value)
+      record_path = argv[++i];
+    else if (arg == "--replay" && has_value)
+      replay_path = argv[++i];
+    else if (arg == "--timings" && has_value)
+      timings_path = argv[++i];
+    else if (arg == "--pipelined-physics")
+      physics_pipeline.pipelined = true;
+    else if (arg == "--late-camera")
+      game_ui_data.late_camera = true;
+    else if (arg == "--tick-rate" && has_value)
+      set_tick_rate(fixed_step, SDL_atof(argv[++i]));
+    else if (arg == "--max-catchup" && has_value)
+      fixed_step.max_steps_per_frame = std::max(SDL_atoi(argv[++i]), 1);
+    else if (arg == "--memory-budget" && i + 2 < argc) {
+      const std::string_view name = argv[++i];
+      const size_t mb = (size_t)std::max(SDL_atoi(argv[++i]), 0);
+      size_t tag = 0;
+      while (tag < MEMORY_TAG_COUNT && name != memory_tag_name((MemoryTag)tag))
+        tag++;
+      if (tag < MEMORY_TAG_COUNT)
+        set_memory_budget(memory_tracker, (MemoryTag)tag, mb << 20);
+      else
+        SDL_Log("Unknown memory tag: %s", argv[i - 1]);
+    } else
+      SDL_Log("Unknown argument: %s", argv[i]);
+  }
+
+  // the seed is recorded, so replays get the same world
+  game_data.seed = 0;
+#if defined(_DEBUG)
+  game_data.seed = get_system_time_for_seed();
+#endif
+
+  // route the libraries through the tracker before anything is allocated.
+  // the registry lives in the dll, which sets its own tracker in game_init()
+  b2SetAllocator(b2_tracked_alloc, b2_tracked_free);
+  ImGui::SetAllocatorFunctions(imgui_tracked_alloc, imgui_tracked_free, &memory_tracker);
+  set_registry_memory(&memory_tracker);
+  game_data.memory = &memory_tracker;
+  game_ui_data.memory = &memory_tracker;
+
+  // owned here, so pending events outlive a dll reload
+  init_frame_arena(game_arena, 1 << 20);
+  init_event_bus(event_bus, 1 << 20);
+  game_data.bus = &event_bus;
+  game_data.frame_arena = &game_arena;
+  init_frame_arena(render_arena, 256 << 10);
+  game_ui_data.frame_arena = &render_arena;
+
+  // the dll sets the same logger for itself in game_init()
+  init_logger(logger);
+  set_logger(&logger);
+  start_logger(logger);
+  game_data.logger = &logger;
+  game_data.make_ui_snapshot = &make_ui_snapshot;
+
   if (!SDL_SetAppMetadata("SomeCoolGame", "1.0", "com.blueberrygames.game"))
     throw SDLException("Couldn't SDL_SetAppMetadata()");
 
-  if (!SDL_Init(SDL_INIT_VIDEO))
-    throw SDLException("Failed to SDL_Init(SDL_INIT_VIDEO)");
+  // #elif __linux__
+  //   "libGameDLL.so";
+  // #elif __APPLE__
+  //   "libGameDLL.dylib";
+  // load game_code dll
+  const auto src_dll = "GameDLL-hot-unlocked.dll";
+  const auto dst_dll = "GameDLL-hot-locked.dll"; // when loaded, system processor locks it
 
-  if (!SDL_Init(SDL_INIT_JOYSTICK))
-    throw SDLException("Failed to SDL_Init(SDL_INIT_JOYSTICK)");
+  // headless: no window, renderthread or joysticks
+  if (!replay_path.empty()) {
+    game_code = sdl_load_game_code(src_dll, dst_dll);
+    const int result = RunReplay();
+    stop_logger(logger);
+    sdl_unload_game_code(&game_code);
+    return result;
+  }
 
-  // setup controllers.
-  int num_joysticks = 0;
-  const SDL_JoystickID* joysticks = SDL_GetJoysticks(&num_joysticks);
-  for (int i = 0; i < num_joysticks; i++) {
-    const SDL_JoystickID id = joysticks[i];
-    const auto* name = SDL_GetJoystickNameForID(id);
-    SDL_Log("Joystick %d: %s", i, name ? name : "Unknown");
+  if (!SDL_Init(SDL_INIT_VIDEO))
+    throw SDLException("Failed to SDL_Init(SDL_INIT_VIDEO)");
 
-    const auto* instance = SDL_OpenJoystick(id);
-    if (instance)
-      SDL_Log("Joystick Connected: success");
-    else
-      SDL_Log("Joystick Connected: fail");
-  }
+  // controllers are opened and closed by the game's input module
+  if (!SDL_Init(SDL_INIT_GAMEPAD))
+    throw SDLException("Failed to SDL_Init(SDL_INIT_GAMEPAD)");
 
   auto flags = SDL_GPU_SHADERFORMAT_SPIRV | SDL_GPU_SHADERFORMAT_MSL | SDL_GPU_SHADERFORMAT_DXIL;
 #if defined(_DEBUG)
@@ -858,14 +1156,6 @@ main(int argc, char* argv[])
 
   // clang-format on
 
-  // #elif __linux__
-  //   "libGameDLL.so";
-  // #elif __APPLE__
-  //   "libGameDLL.dylib";
-  // load game_code dll
-  const auto src_dll = "GameDLL-hot-unlocked.dll";
-  const auto dst_dll = "GameDLL-hot-locked.dll"; // when loaded, system processor locks it
-
   // Load GameDLL.dll on launch
   game_code = sdl_load_game_code(src_dll, dst_dll);
 
@@ -910,7 +1200,9 @@ main(int argc, char* argv[])
     }
 
     // push all the events at once in to a thread-safe vector.
-    event_queue.enqueue(evts);
+    // the poll time is only kept for batches with input in them
+    const bool has_input = std::any_of(evts.begin(), evts.end(), is_input_event);
+    event_queue.enqueue(evts, has_input ? SDL_GetTicksNS() : 0);
 
     // Call SDL_GetMouseState on main thread.
     SDL_GetMouseState(&mouse_pos.x, &mouse_pos.y);
@@ -935,6 +1227,8 @@ main(int argc, char* argv[])
 
       if (result == 0) {
         SDL_Log("Build success...");
+        // records point at format strings in the dll
+        flush_logger(logger);
         sdl_unload_game_code(&game_code);
         game_code = sdl_load_game_code(src_dll, dst_dll);
         game_code.rebuilt = true;
@@ -946,6 +1240,7 @@ main(int argc, char* argv[])
 
   game_thread.join();
   render_thread.join();
+  stop_logger(logger);
 
   SDL_ReleaseWindowFromGPUDevice(device, window);
   SDL_DestroyWindow(window);
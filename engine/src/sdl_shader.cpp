@@ -56,14 +56,12 @@ LoadShader(SDL_GPUDevice* device,
     return NULL;
   }
 
-  const auto load_str = std::format("Loading shader... {}", full_path);
-  SDL_Log("%s", load_str.c_str());
+  SDL_Log("Loading shader... %s", full_path);
 
   size_t codeSize;
   void* code = SDL_LoadFile(full_path, &codeSize);
   if (code == NULL) {
-    const auto err_str = std::format("Failed to load shader from disk! {}", full_path);
-    SDL_Log("%s", err_str.c_str());
+    SDL_Log("Failed to load shader from disk! %s", full_path);
     return NULL;
   }
 
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstdint>
 #include <mutex>
 #include <vector>
 
@@ -8,25 +9,34 @@ namespace game2d {
 template<typename T>
 struct EventQueue
 {
-  void enqueue(const std::vector<T>& t)
+  // stamp_ns is when the batch was produced. the queue keeps the oldest
+  // stamp that has not been dequeued, so batches merged between two
+  // dequeues report their earliest time.
+  void enqueue(const std::vector<T>& t, const uint64_t stamp_ns = 0)
   {
     std::lock_guard<std::mutex> lock(m);
 
     data.insert(data.end(), t.begin(), t.end());
+    if (stamp_ns != 0 && (oldest_stamp_ns == 0 || stamp_ns < oldest_stamp_ns))
+      oldest_stamp_ns = stamp_ns;
   };
 
-  std::vector<T> dequeue_all()
+  // swaps the pending events in to out, and out's old buffer becomes the queue's.
+  // the two buffers are reused every frame, so nothing is allocated once they have grown.
+  void dequeue_all(std::vector<T>& out, uint64_t* stamp_ns = nullptr)
   {
-    std::lock_guard<std::mutex> lock(m);
-
-    if (data.size() > 0)
-      return std::move(data);
+    out.clear();
 
-    return {};
+    std::lock_guard<std::mutex> lock(m);
+    data.swap(out);
+    if (stamp_ns)
+      *stamp_ns = oldest_stamp_ns;
+    oldest_stamp_ns = 0;
   }
 
 private:
   std::vector<T> data;
+  uint64_t oldest_stamp_ns = 0;
   mutable std::mutex m;
 };
 
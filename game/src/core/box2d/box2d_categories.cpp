@@ -0,0 +1,57 @@
+#include "core/pch.hpp"
+
+#include "core/box2d/box2d_categories.hpp"
+
+namespace game2d {
+
+void
+apply_collision_filter(const b2ShapeId shape_id, const CollisionCategory category, const CollisionMasks& masks)
+{
+  const uint64_t interested_in = masks[(size_t)category];
+  const bool has_handlers = interested_in != 0;
+  const bool is_sensor = b2Shape_IsSensor(shape_id);
+
+  // a sensor does not collide, its mask only picks what it reports
+  b2Filter filter = b2Shape_GetFilter(shape_id);
+  filter.categoryBits = category_bit(category);
+  filter.maskBits = is_sensor && has_handlers ? interested_in : B2_DEFAULT_MASK_BITS;
+  b2Shape_SetFilter(shape_id, filter);
+
+  // Box2D reports a contact if either shape has events on,
+  // and a sensor only sees shapes with sensor events on.
+  // pairs between two unhandled categories are never reported.
+  b2Shape_EnableContactEvents(shape_id, has_handlers && !is_sensor);
+  b2Shape_EnableSensorEvents(shape_id, has_handlers);
+};
+
+void
+dispatch_collisions(Registry& r, const CollisionHandlerTable& table, std::span<const CollisionPair> pairs)
+{
+  for (const CollisionPair& pair : pairs) {
+    if (pair.category_a >= N_COLLISION_CATEGORIES || pair.category_b >= N_COLLISION_CATEGORIES)
+      continue;
+    const CollisionHandlerEntry& entry = table[pair.category_a][pair.category_b];
+    if (entry.fn == nullptr)
+      continue;
+
+    // destroyed since the events were gathered
+    if (!r.valid(pair.parent_a) || !r.valid(pair.parent_b))
+      continue;
+
+    if (!entry.swap) {
+      entry.fn(r, pair);
+      continue;
+    }
+
+    CollisionPair swapped;
+    swapped.parent_a = pair.parent_b;
+    swapped.parent_b = pair.parent_a;
+    swapped.shape_a = pair.shape_b;
+    swapped.shape_b = pair.shape_a;
+    swapped.category_a = pair.category_b;
+    swapped.category_b = pair.category_a;
+    entry.fn(r, swapped);
+  }
+};
+
+} // namespace game2d
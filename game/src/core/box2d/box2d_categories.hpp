@@ -0,0 +1,90 @@
+#pragma once
+
+#include "core/box2d/box2d_collisions.hpp"
+#include "core/registry.hpp"
+
+#include <entt/fwd.hpp>
+
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <span>
+
+namespace game2d {
+
+// Each body gets one category, derived from its tag components.
+// Used as the bit index in b2Filter::categoryBits.
+enum class CollisionCategory : uint8_t
+{
+  DEFAULT = 0,
+  PLAYER,
+  CONTAINER_PROVIDER,
+  CONTAINER_RECEIVER,
+  COUNT,
+};
+
+constexpr size_t N_COLLISION_CATEGORIES = (size_t)CollisionCategory::COUNT;
+
+constexpr uint64_t
+category_bit(const CollisionCategory c)
+{
+  return uint64_t(1) << (uint64_t)c;
+};
+
+// the lowest bit set. no bits, or a bit past COUNT, is DEFAULT
+constexpr CollisionCategory
+category_from_bits(const uint64_t bits)
+{
+  const int i = std::countr_zero(bits);
+  return i < (int)N_COLLISION_CATEGORIES ? (CollisionCategory)i : CollisionCategory::DEFAULT;
+};
+
+// pair.parent_a is always the first category the handler was added with
+using CollisionPairHandler = void (*)(Registry& r, const CollisionPair& pair);
+
+struct CollisionHandlerEntry
+{
+  CollisionPairHandler fn = nullptr;
+  bool swap = false;
+};
+
+// [category_a][category_b] => handler
+using CollisionHandlerTable = std::array<std::array<CollisionHandlerEntry, N_COLLISION_CATEGORIES>, N_COLLISION_CATEGORIES>;
+
+// masks[category] has a bit set for each category it has a handler with
+using CollisionMasks = std::array<uint64_t, N_COLLISION_CATEGORIES>;
+
+constexpr void
+add_collision_handler(CollisionHandlerTable& table,
+                      const CollisionCategory a,
+                      const CollisionCategory b,
+                      const CollisionPairHandler fn)
+{
+  table[(size_t)a][(size_t)b] = { .fn = fn, .swap = false };
+  if (a != b)
+    table[(size_t)b][(size_t)a] = { .fn = fn, .swap = true };
+};
+
+constexpr CollisionMasks
+make_collision_masks(const CollisionHandlerTable& table)
+{
+  CollisionMasks masks{};
+  for (size_t a = 0; a < N_COLLISION_CATEGORIES; a++)
+    for (size_t b = 0; b < N_COLLISION_CATEGORIES; b++)
+      if (table[a][b].fn != nullptr)
+        masks[a] |= category_bit((CollisionCategory)b);
+  return masks;
+};
+
+// Sets the shape's category, and which of its events Box2D reports.
+// Solid shapes keep the default mask, so tags never change what a body collides with.
+// Sensors only see the categories they have a handler with.
+// Events are only on for categories with handlers.
+void
+apply_collision_filter(const b2ShapeId shape_id, const CollisionCategory category, const CollisionMasks& masks);
+
+// one table lookup per pair
+void
+dispatch_collisions(Registry& r, const CollisionHandlerTable& table, std::span<const CollisionPair> pairs);
+
+} // namespace game2d
@@ -0,0 +1,60 @@
+#include "core/pch.hpp"
+
+#include "core/box2d/box2d_collisions.hpp"
+
+#include "core/box2d/box2d_categories.hpp"
+#include "core/box2d/box2d_helpers.hpp"
+
+namespace game2d {
+
+static CollisionPair
+make_collision_pair(const b2ShapeId a, const b2ShapeId b)
+{
+  CollisionPair pair;
+  pair.shape_a = get_entity_from_shape_id(a);
+  pair.shape_b = get_entity_from_shape_id(b);
+  pair.parent_a = get_entity_from_body_id(b2Shape_GetBody(a));
+  pair.parent_b = get_entity_from_body_id(b2Shape_GetBody(b));
+  pair.category_a = (uint8_t)category_from_bits(b2Shape_GetFilter(a).categoryBits);
+  pair.category_b = (uint8_t)category_from_bits(b2Shape_GetFilter(b).categoryBits);
+  assert(pair.shape_a != entt::null);
+  assert(pair.shape_b != entt::null);
+  return pair;
+};
+
+void
+gather_collision_events(const b2WorldId world_id, CollisionEvents& events)
+{
+  const b2ContactEvents c_events = b2World_GetContactEvents(world_id);
+  const b2SensorEvents s_events = b2World_GetSensorEvents(world_id);
+  events.n_contact_events = c_events.beginCount + c_events.endCount;
+  events.n_sensor_events = s_events.beginCount + s_events.endCount;
+
+  events.enter.clear();
+  events.exit.clear();
+  events.enter.reserve(c_events.beginCount + s_events.beginCount);
+  events.exit.reserve(c_events.endCount + s_events.endCount);
+
+  for (int i = 0; i < c_events.beginCount; ++i) {
+    const b2ContactBeginTouchEvent& evt = c_events.beginEvents[i];
+    events.enter.push_back(make_collision_pair(evt.shapeIdA, evt.shapeIdB));
+  }
+  for (int i = 0; i < s_events.beginCount; ++i) {
+    const b2SensorBeginTouchEvent& evt = s_events.beginEvents[i];
+    events.enter.push_back(make_collision_pair(evt.sensorShapeId, evt.visitorShapeId));
+  }
+
+  // shapes could have been destroyed since they stopped touching
+  for (int i = 0; i < c_events.endCount; ++i) {
+    const b2ContactEndTouchEvent& evt = c_events.endEvents[i];
+    if (b2Shape_IsValid(evt.shapeIdA) && b2Shape_IsValid(evt.shapeIdB))
+      events.exit.push_back(make_collision_pair(evt.shapeIdA, evt.shapeIdB));
+  }
+  for (int i = 0; i < s_events.endCount; ++i) {
+    const b2SensorEndTouchEvent& evt = s_events.endEvents[i];
+    if (b2Shape_IsValid(evt.sensorShapeId) && b2Shape_IsValid(evt.visitorShapeId))
+      events.exit.push_back(make_collision_pair(evt.sensorShapeId, evt.visitorShapeId));
+  }
+};
+
+} // namespace game2d
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <box2d/box2d.h>
+#include <entt/entt.hpp>
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace game2d {
+
+// A begin or end touch, with the parent (body) and shape entities
+// already resolved from the box2d user data.
+struct CollisionPair
+{
+  entt::entity parent_a = entt::null;
+  entt::entity parent_b = entt::null;
+  entt::entity shape_a = entt::null;
+  entt::entity shape_b = entt::null;
+
+  // CollisionCategory of each shape, read from its b2Filter
+  uint8_t category_a = 0;
+  uint8_t category_b = 0;
+};
+
+// contact and sensor events from the last b2World_Step(),
+// kept in contiguous buffers that are reused every step.
+struct CollisionEvents
+{
+  std::vector<CollisionPair> enter;
+  std::vector<CollisionPair> exit;
+
+  int n_contact_events = 0;
+  int n_sensor_events = 0;
+};
+
+void
+gather_collision_events(const b2WorldId world_id, CollisionEvents& events);
+
+} // namespace game2d
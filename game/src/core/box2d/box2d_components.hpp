@@ -3,13 +3,26 @@
 #include <box2d/box2d.h>
 #include <entt/entt.hpp>
 
+#include <array>
+#include <type_traits>
+
 namespace game2d {
 
+constexpr int MAX_SHAPES_PER_BODY = 4;
+
 struct PhysicsBodyComponent
 {
   b2BodyId id = B2_ZERO_INIT;
-  std::vector<b2ShapeId> shape_ids;
+
+  // shapes are stored inline, see make_physics_body_component()
+  std::array<b2ShapeId, MAX_SHAPES_PER_BODY> shape_ids{};
+  int n_shapes = 0;
+
+  // union of the shape aabbs relative to the body origin (meters).
+  // cached on creation; bodies have fixed rotation.
+  b2AABB local_aabb = { { 0.0f, 0.0f }, { 0.0f, 0.0f } };
 };
+static_assert(std::is_trivially_copyable_v<PhysicsBodyComponent>);
 
 struct PhysicsShapeComponent
 {
@@ -17,39 +30,4 @@ struct PhysicsShapeComponent
   b2ShapeId shape_id = B2_ZERO_INIT;
 };
 
-//
-// events
-//
-
-struct OnCollisionEnter
-{
-  entt::entity shape_a = entt::null;
-  entt::entity shape_b = entt::null;
-};
-
-struct OnCollisionExit
-{
-  entt::entity shape_a = entt::null;
-  entt::entity shape_b = entt::null;
-};
-
-template<class A, class B>
-std::pair<entt::entity, entt::entity>
-coll(entt::registry& r, entt::entity a, entt::entity b)
-{
-  {
-    const auto a_has_type_a = r.all_of<A>(a);
-    const auto b_has_type_b = r.all_of<B>(b);
-    if (a_has_type_a && b_has_type_b)
-      return { a, b };
-  }
-  {
-    const auto a_has_type_b = r.all_of<B>(a);
-    const auto b_has_type_a = r.all_of<A>(b);
-    if (a_has_type_b && b_has_type_a)
-      return { b, a };
-  }
-  return { entt::null, entt::null };
-};
-
 } // namespace game2d
\ No newline at end of file
@@ -3,19 +3,26 @@
 #include "core/box2d/box2d_helpers.hpp"
 
 #include "core/box2d/box2d_components.hpp"
+#include "core/log/log.hpp"
 
 namespace game2d {
 
+void*
+entity_to_user_data(const entt::entity eid)
+{
+  return (void*)static_cast<uintptr_t>(entt::to_integral(eid));
+};
+
 void
 set_entity_from_body_id(const b2BodyId id, const entt::entity eid)
 {
-  b2Body_SetUserData(id, (void*)static_cast<uintptr_t>(entt::to_integral(eid)));
+  b2Body_SetUserData(id, entity_to_user_data(eid));
 }
 
 void
 set_entity_from_shape_id(const b2ShapeId id, const entt::entity eid)
 {
-  b2Shape_SetUserData(id, (void*)static_cast<uintptr_t>(entt::to_integral(eid)));
+  b2Shape_SetUserData(id, entity_to_user_data(eid));
 }
 
 entt::entity
@@ -31,20 +38,36 @@ get_entity_from_shape_id(const b2ShapeId id)
 };
 
 entt::entity
-get_parent_entity_from_shape_id(entt::registry& r, const b2ShapeId id)
+get_parent_entity_from_shape_id(Registry& r, const b2ShapeId id)
 {
   const auto shape_e = get_entity_from_shape_id(id);
   const auto& shape_c = r.get<const PhysicsShapeComponent>(shape_e);
   return get_entity_from_body_id(shape_c.body_id);
 };
 
-std::vector<b2ShapeId>
-get_shapes(b2BodyId id)
+PhysicsBodyComponent
+make_physics_body_component(const b2BodyId id)
 {
+  PhysicsBodyComponent pb_c;
+  pb_c.id = id;
+
+  // the extra shapes still collide, but get no filter and are not in the aabb
   const int n_shapes = b2Body_GetShapeCount(id);
-  std::vector<b2ShapeId> ids(n_shapes);
-  b2Body_GetShapes(id, ids.data(), (int)ids.size());
-  return ids;
+  if (n_shapes > MAX_SHAPES_PER_BODY)
+    LOG(ERR, PHYSICS, "body has %i shapes, only the first %i are tracked", n_shapes, MAX_SHAPES_PER_BODY);
+  pb_c.n_shapes = b2Body_GetShapes(id, pb_c.shape_ids.data(), MAX_SHAPES_PER_BODY);
+
+  if (pb_c.n_shapes == 0)
+    return pb_c;
+
+  b2AABB aabb = b2Shape_GetAABB(pb_c.shape_ids[0]);
+  for (int i = 1; i < pb_c.n_shapes; i++)
+    aabb = b2AABB_Union(aabb, b2Shape_GetAABB(pb_c.shape_ids[i]));
+
+  const b2Vec2 pos = b2Body_GetPosition(id);
+  pb_c.local_aabb.lowerBound = b2Sub(aabb.lowerBound, pos);
+  pb_c.local_aabb.upperBound = b2Sub(aabb.upperBound, pos);
+  return pb_c;
 };
 
 constexpr float PIXELS_PER_METER = 50;
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "core/box2d/box2d_components.hpp"
 #include "core/common.hpp"
 
 #include <box2d/box2d.h>
@@ -7,6 +8,10 @@
 
 namespace game2d {
 
+// for b2BodyDef::userData and b2ShapeDef::userData, set before the body or shape is created
+void*
+entity_to_user_data(const entt::entity eid);
+
 void
 set_entity_from_body_id(const b2BodyId id, const entt::entity eid);
 
@@ -20,10 +25,11 @@ entt::entity
 get_entity_from_shape_id(const b2ShapeId id);
 
 entt::entity
-get_parent_entity_from_shape_id(entt::registry& r, const b2ShapeId id);
+get_parent_entity_from_shape_id(Registry& r, const b2ShapeId id);
 
-std::vector<b2ShapeId>
-get_shapes(b2BodyId id);
+// call once the body has all of its shapes
+PhysicsBodyComponent
+make_physics_body_component(const b2BodyId id);
 
 float
 meters_to_pixels(float meters);
@@ -0,0 +1,47 @@
+#include "core/pch.hpp"
+
+#include "core/box2d/box2d_query.hpp"
+
+#include "core/box2d/box2d_helpers.hpp"
+
+namespace game2d {
+
+struct QueryPointContext
+{
+  b2Vec2 point;
+  std::vector<entt::entity>* results = nullptr;
+};
+
+static bool
+query_point_callback(b2ShapeId shape_id, void* context)
+{
+  auto* ctx = static_cast<QueryPointContext*>(context);
+
+  // the broadphase only tests fat aabbs
+  if (b2Shape_TestPoint(shape_id, ctx->point))
+    ctx->results->push_back(get_entity_from_body_id(b2Shape_GetBody(shape_id)));
+
+  return true; // keep going
+};
+
+void
+query_point(const b2WorldId world_id, const vec2 point, std::vector<entt::entity>& results)
+{
+  results.clear();
+
+  QueryPointContext ctx;
+  ctx.point = pixels_to_meters(point);
+  ctx.results = &results;
+
+  constexpr float epsilon = 0.001f;
+  b2AABB aabb;
+  aabb.lowerBound = { ctx.point.x - epsilon, ctx.point.y - epsilon };
+  aabb.upperBound = { ctx.point.x + epsilon, ctx.point.y + epsilon };
+  b2World_OverlapAABB(world_id, aabb, b2DefaultQueryFilter(), query_point_callback, &ctx);
+
+  // a body with many shapes under the point is reported once
+  std::sort(results.begin(), results.end());
+  results.erase(std::unique(results.begin(), results.end()), results.end());
+};
+
+} // namespace game2d
@@ -0,0 +1,18 @@
+#pragma once
+
+#include "core/common.hpp"
+
+#include <box2d/box2d.h>
+#include <entt/fwd.hpp>
+
+#include <vector>
+
+namespace game2d {
+
+// Finds the parent entity of every shape under the point (pixels),
+// using the broadphase so cost depends on what is nearby, not world size.
+// results is cleared and reused, so pass the same buffer each call.
+void
+query_point(const b2WorldId world_id, const vec2 point, std::vector<entt::entity>& results);
+
+} // namespace game2d
@@ -1,5 +1,7 @@
 #pragma once
 
+#include "core/registry.hpp"
+
 #include <entt/entt.hpp>
 
 #include <optional>
@@ -9,7 +11,7 @@ namespace game2d {
 
 template<class T>
 entt::entity
-create_empty(entt::registry& r, const std::optional<T>& val = std::nullopt)
+create_empty(Registry& r, const std::optional<T>& val = std::nullopt)
 {
   // val passed in. could be useful for debugging
 
@@ -0,0 +1,266 @@
+#include "core/pch.hpp"
+
+#include "input.hpp"
+
+#include "core/log/log.hpp"
+
+namespace game2d {
+
+static int
+find_device(const InputState& input, const SDL_JoystickID id)
+{
+  for (int i = 0; i < input.n_devices; i++)
+    if (input.devices[i].id == id)
+      return i;
+  return -1;
+};
+
+static void
+open_device(InputState& input, const SDL_JoystickID id)
+{
+  if (find_device(input, id) >= 0)
+    return;
+  if (input.n_devices == MAX_INPUT_DEVICES) {
+    LOG(WARN, INPUT, "too many devices, ignoring %i", id);
+    return;
+  }
+
+  InputDevice device;
+  device.id = id;
+
+  // a replay. a gamepad says so with GAMEPAD_ADDED
+  if (!input.open_devices) {
+    LOG(INFO, INPUT, "tracking device %i", id);
+    input.devices[input.n_devices++] = device;
+    return;
+  }
+
+  device.is_gamepad = SDL_IsGamepad(id);
+  if (device.is_gamepad)
+    device.gamepad = SDL_OpenGamepad(id);
+  else
+    device.joystick = SDL_OpenJoystick(id);
+  if (device.gamepad == nullptr && device.joystick == nullptr) {
+    LOG(WARN, INPUT, "could not open device %i: %s", id, SDL_GetError());
+    return;
+  }
+
+  LOG(INFO, INPUT, "opened %s %i", device.gamepad ? "gamepad" : "joystick", id);
+  input.devices[input.n_devices++] = device;
+};
+
+// SDL sends GAMEPAD_ADDED after JOYSTICK_ADDED, or once a mapping for the joystick is added
+static void
+mark_gamepad(InputState& input, const SDL_JoystickID id)
+{
+  open_device(input, id);
+  const int i = find_device(input, id);
+  if (i < 0 || input.devices[i].is_gamepad)
+    return;
+
+  InputDevice& device = input.devices[i];
+  device.is_gamepad = true;
+  if (!input.open_devices)
+    return;
+
+  SDL_Gamepad* gamepad = SDL_OpenGamepad(id);
+  if (gamepad == nullptr) {
+    LOG(WARN, INPUT, "could not open gamepad %i: %s", id, SDL_GetError());
+    device.is_gamepad = false;
+    return;
+  }
+  if (device.joystick)
+    SDL_CloseJoystick(device.joystick);
+  device.joystick = nullptr;
+  device.gamepad = gamepad;
+};
+
+static void
+close_device(InputState& input, const SDL_JoystickID id)
+{
+  const int i = find_device(input, id);
+  if (i < 0)
+    return;
+
+  InputDevice& device = input.devices[i];
+  if (device.gamepad)
+    SDL_CloseGamepad(device.gamepad);
+  if (device.joystick)
+    SDL_CloseJoystick(device.joystick);
+  LOG(INFO, INPUT, "closed device %i", id);
+
+  input.devices[i] = input.devices[input.n_devices - 1];
+  input.devices[--input.n_devices] = InputDevice{};
+};
+
+static void
+set_action(InputState& input, const InputAction action, const bool down)
+{
+  if (action == InputAction::COUNT)
+    return;
+  const size_t i = (size_t)action;
+  if (down && !input.held.test(i))
+    input.pressed.set(i);
+  if (!down && input.held.test(i))
+    input.released.set(i);
+  input.held.set(i, down);
+};
+
+static void
+set_device_axis(InputState& input, const SDL_JoystickID id, const uint8_t axis, const int16_t raw)
+{
+  const int i = find_device(input, id);
+  if (i < 0 || axis >= SDL_GAMEPAD_AXIS_COUNT)
+    return;
+
+  float value = raw < 0 ? (float)raw / 32768.0f : (float)raw / 32767.0f;
+  if (SDL_fabsf(value) < INPUT_DEADZONE)
+    value = 0.0f;
+  input.devices[i].axes[axis] = value;
+};
+
+void
+init_input(InputState& input)
+{
+  InputBindings& b = input.bindings;
+  b.keys.fill(InputAction::COUNT);
+  b.buttons.fill(InputAction::COUNT);
+  b.mouse_buttons.fill(InputAction::COUNT);
+  b.axes.fill(InputAxis::COUNT);
+
+  bind_key(input, SDL_SCANCODE_W, InputAction::MOVE_UP);
+  bind_key(input, SDL_SCANCODE_S, InputAction::MOVE_DOWN);
+  bind_key(input, SDL_SCANCODE_A, InputAction::MOVE_LEFT);
+  bind_key(input, SDL_SCANCODE_D, InputAction::MOVE_RIGHT);
+  bind_key(input, SDL_SCANCODE_UP, InputAction::CAMERA_UP);
+  bind_key(input, SDL_SCANCODE_DOWN, InputAction::CAMERA_DOWN);
+  bind_key(input, SDL_SCANCODE_LEFT, InputAction::CAMERA_LEFT);
+  bind_key(input, SDL_SCANCODE_RIGHT, InputAction::CAMERA_RIGHT);
+  bind_key(input, SDL_SCANCODE_SPACE, InputAction::JUMP);
+  bind_key(input, SDL_SCANCODE_RETURN, InputAction::PICKUP);
+  bind_key(input, SDL_SCANCODE_G, InputAction::SPAWN_AGENTS);
+  bind_key(input, SDL_SCANCODE_KP_9, InputAction::FORCE_GAMEOVER);
+  bind_key(input, SDL_SCANCODE_F5, InputAction::QUICKSAVE);
+  bind_key(input, SDL_SCANCODE_F6, InputAction::QUICKLOAD);
+  bind_gamepad_button(input, SDL_GAMEPAD_BUTTON_SOUTH, InputAction::PICKUP);
+  bind_mouse_button(input, SDL_BUTTON_LEFT, InputAction::PICK);
+  bind_mouse_button(input, SDL_BUTTON_RIGHT, InputAction::SPAWN);
+  bind_gamepad_axis(input, SDL_GAMEPAD_AXIS_LEFTX, InputAxis::MOVE_X);
+  bind_gamepad_axis(input, SDL_GAMEPAD_AXIS_LEFTY, InputAxis::MOVE_Y);
+  bind_gamepad_axis(input, SDL_GAMEPAD_AXIS_RIGHTX, InputAxis::CAMERA_X);
+  bind_gamepad_axis(input, SDL_GAMEPAD_AXIS_RIGHTY, InputAxis::CAMERA_Y);
+
+  input.held.reset();
+  input.pressed.reset();
+  input.released.reset();
+  input.axes.fill(0.0f);
+
+  // later devices arrive as JOYSTICK_ADDED events.
+  // in a replay, so do the ones that were connected when the recording started
+  if (!input.enumerated) {
+    input.enumerated = true;
+    if (!input.open_devices)
+      return;
+    int n = 0;
+    SDL_JoystickID* ids = SDL_GetJoysticks(&n);
+    for (int i = 0; i < n; i++)
+      open_device(input, ids[i]);
+    SDL_free(ids);
+  }
+};
+
+void
+shutdown_input(InputState& input)
+{
+  while (input.n_devices > 0)
+    close_device(input, input.devices[0].id);
+  input.enumerated = false;
+};
+
+void
+bind_key(InputState& input, const SDL_Scancode key, const InputAction action)
+{
+  input.bindings.keys[key] = action;
+};
+
+void
+bind_gamepad_button(InputState& input, const SDL_GamepadButton button, const InputAction action)
+{
+  input.bindings.buttons[button] = action;
+};
+
+void
+bind_mouse_button(InputState& input, const uint8_t button, const InputAction action)
+{
+  if (button < MAX_MOUSE_BUTTONS)
+    input.bindings.mouse_buttons[button] = action;
+};
+
+void
+bind_gamepad_axis(InputState& input, const SDL_GamepadAxis axis, const InputAxis to)
+{
+  input.bindings.axes[axis] = to;
+};
+
+void
+update_input(InputState& input, std::span<const SDL_Event> events)
+{
+  const InputBindings& b = input.bindings;
+  input.pressed.reset();
+  input.released.reset();
+
+  for (const SDL_Event& evt : events) {
+    switch (evt.type) {
+      case SDL_EVENT_KEY_DOWN:
+      case SDL_EVENT_KEY_UP:
+        if (!evt.key.repeat)
+          set_action(input, b.keys[evt.key.scancode], evt.key.down);
+        break;
+      case SDL_EVENT_MOUSE_BUTTON_DOWN:
+      case SDL_EVENT_MOUSE_BUTTON_UP:
+        if (evt.button.button < MAX_MOUSE_BUTTONS)
+          set_action(input, b.mouse_buttons[evt.button.button], evt.button.down);
+        break;
+      case SDL_EVENT_GAMEPAD_BUTTON_DOWN:
+      case SDL_EVENT_GAMEPAD_BUTTON_UP:
+        if (evt.gbutton.button < SDL_GAMEPAD_BUTTON_COUNT)
+          set_action(input, b.buttons[evt.gbutton.button], evt.gbutton.down);
+        break;
+      case SDL_EVENT_GAMEPAD_AXIS_MOTION:
+        set_device_axis(input, evt.gaxis.which, evt.gaxis.axis, evt.gaxis.value);
+        break;
+      case SDL_EVENT_JOYSTICK_AXIS_MOTION: {
+        // gamepads send these too, from the joystick under them
+        const int i = find_device(input, evt.jaxis.which);
+        if (i >= 0 && !input.devices[i].is_gamepad)
+          set_device_axis(input, evt.jaxis.which, evt.jaxis.axis, evt.jaxis.value);
+        break;
+      }
+      case SDL_EVENT_JOYSTICK_ADDED:
+        open_device(input, evt.jdevice.which);
+        break;
+      case SDL_EVENT_GAMEPAD_ADDED:
+        mark_gamepad(input, evt.gdevice.which);
+        break;
+      case SDL_EVENT_GAMEPAD_REMOVED: // before JOYSTICK_REMOVED, closing twice is a no-op
+        close_device(input, evt.gdevice.which);
+        break;
+      case SDL_EVENT_JOYSTICK_REMOVED:
+        close_device(input, evt.jdevice.which);
+        break;
+      default:
+        break;
+    }
+  }
+
+  // the first device drives the axes
+  input.axes.fill(0.0f);
+  if (input.n_devices > 0) {
+    const InputDevice& device = input.devices[0];
+    for (size_t i = 0; i < device.axes.size(); i++)
+      if (b.axes[i] != InputAxis::COUNT)
+        input.axes[(size_t)b.axes[i]] = device.axes[i];
+  }
+};
+
+} // namespace game2d
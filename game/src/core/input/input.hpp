@@ -0,0 +1,137 @@
+#pragma once
+
+#include <SDL3/SDL.h>
+
+#include <array>
+#include <bitset>
+#include <cstdint>
+#include <span>
+
+//
+// Raw inputs are mapped to actions and axes through lookup tables,
+// so a frame's input costs O(events + actions) and allocates nothing.
+// Devices are opened when SDL adds them and closed when it removes them,
+// instead of being asked for every frame.
+// Replays run without SDL_Init, so there devices are only tracked by id.
+//
+
+namespace game2d {
+
+enum class InputAction : uint8_t
+{
+  MOVE_UP,
+  MOVE_DOWN,
+  MOVE_LEFT,
+  MOVE_RIGHT,
+  CAMERA_UP,
+  CAMERA_DOWN,
+  CAMERA_LEFT,
+  CAMERA_RIGHT,
+  JUMP,
+  PICKUP,
+  PICK,  // at the mouse
+  SPAWN, // at the mouse
+  SPAWN_AGENTS,
+  FORCE_GAMEOVER,
+  QUICKSAVE,
+  QUICKLOAD,
+  COUNT, // unbound
+};
+constexpr size_t INPUT_ACTION_COUNT = (size_t)InputAction::COUNT;
+
+enum class InputAxis : uint8_t
+{
+  MOVE_X,
+  MOVE_Y,
+  CAMERA_X,
+  CAMERA_Y,
+  COUNT, // unbound
+};
+constexpr size_t INPUT_AXIS_COUNT = (size_t)InputAxis::COUNT;
+
+constexpr int MAX_INPUT_DEVICES = 8;
+constexpr int MAX_MOUSE_BUTTONS = 8;
+constexpr float INPUT_DEADZONE = 0.01f;
+
+struct InputDevice
+{
+  SDL_JoystickID id = 0;
+  SDL_Gamepad* gamepad = nullptr;   // if SDL knows the mapping
+  SDL_Joystick* joystick = nullptr; // otherwise
+  bool is_gamepad = false;          // its axes come from gamepad events
+  std::array<float, SDL_GAMEPAD_AXIS_COUNT> axes{}; // -1 to 1, from axis motion events
+};
+
+struct InputBindings
+{
+  std::array<InputAction, SDL_SCANCODE_COUNT> keys;
+  std::array<InputAction, SDL_GAMEPAD_BUTTON_COUNT> buttons;
+  std::array<InputAction, MAX_MOUSE_BUTTONS> mouse_buttons;
+  std::array<InputAxis, SDL_GAMEPAD_AXIS_COUNT> axes; // joysticks use the same indices
+};
+
+struct InputState
+{
+  InputBindings bindings;
+
+  std::array<InputDevice, MAX_INPUT_DEVICES> devices;
+  int n_devices = 0;
+  bool enumerated = false;  // devices connected before init were opened
+  bool open_devices = true; // false: track devices by id, open nothing
+
+  // this frame
+  std::bitset<INPUT_ACTION_COUNT> held;
+  std::bitset<INPUT_ACTION_COUNT> pressed;
+  std::bitset<INPUT_ACTION_COUNT> released;
+  std::array<float, INPUT_AXIS_COUNT> axes{}; // from the first device
+};
+
+// the default bindings. opens the devices that are already connected, once,
+// unless open_devices is false
+void
+init_input(InputState& input);
+
+// closes every device
+void
+shutdown_input(InputState& input);
+
+void
+bind_key(InputState& input, const SDL_Scancode key, const InputAction action);
+
+void
+bind_gamepad_button(InputState& input, const SDL_GamepadButton button, const InputAction action);
+
+void
+bind_mouse_button(InputState& input, const uint8_t button, const InputAction action);
+
+void
+bind_gamepad_axis(InputState& input, const SDL_GamepadAxis axis, const InputAxis to);
+
+void
+update_input(InputState& input, std::span<const SDL_Event> events);
+
+inline bool
+action_held(const InputState& input, const InputAction action)
+{
+  return input.held.test((size_t)action);
+};
+
+inline bool
+action_pressed(const InputState& input, const InputAction action)
+{
+  return input.pressed.test((size_t)action);
+};
+
+inline bool
+action_released(const InputState& input, const InputAction action)
+{
+  return input.released.test((size_t)action);
+};
+
+inline float
+input_axis(const InputState& input, const InputAxis axis)
+{
+  return input.axes[(size_t)axis];
+};
+
+} // namespace game2d
@@ -0,0 +1,190 @@
+#include "core/pch.hpp"
+
+#include "inventory_pool.hpp"
+
+namespace game2d {
+
+static void
+free_range(InventoryPool& pool, InventoryRange range)
+{
+  // from before the pool was cleared
+  if (range.capacity == 0 || range.offset + range.capacity > pool.slots.size())
+    return;
+
+  auto& free = pool.free;
+  auto it = std::lower_bound(free.begin(), free.end(), range.offset, [](const InventoryRange& a, const uint32_t offset) {
+    return a.offset < offset;
+  });
+
+  // merge with the next range, then the previous one
+  if (it != free.end() && range.offset + range.capacity == it->offset) {
+    range.capacity += it->capacity;
+    it = free.erase(it);
+  }
+  if (it != free.begin() && std::prev(it)->offset + std::prev(it)->capacity == range.offset) {
+    --it;
+    it->capacity += range.capacity;
+  } else
+    it = free.insert(it, range);
+
+  // nothing after it is used
+  if (it->offset + it->capacity == pool.slots.size()) {
+    pool.slots.resize(it->offset);
+    free.erase(it);
+  }
+};
+
+static void
+release_inventory(Registry& r, const entt::entity e)
+{
+  const auto& inv = r.get<const InventoryComponent>(e);
+  free_range(get_inventory_pool(r), { .offset = inv.offset, .capacity = inv.capacity });
+};
+
+void
+init_inventory_pool(Registry& r)
+{
+  get_inventory_pool(r);
+
+  // entt ignores a free function that is already connected
+  r.on_destroy<InventoryComponent>().connect<&release_inventory>();
+};
+
+InventoryPool&
+get_inventory_pool(Registry& r)
+{
+  if (auto* pool = r.ctx().find<InventoryPool>())
+    return *pool;
+  return r.ctx().emplace<InventoryPool>();
+};
+
+void
+clear_inventory_pool(Registry& r)
+{
+  InventoryPool& pool = get_inventory_pool(r);
+  pool.slots.clear();
+  pool.free.clear();
+};
+
+void
+rebuild_inventory_free_ranges(Registry& r)
+{
+  InventoryPool& pool = get_inventory_pool(r);
+  pool.free.clear();
+
+  std::vector<InventoryRange> used;
+  for (const auto& [e, inv] : r.view<const InventoryComponent>().each())
+    used.push_back({ .offset = inv.offset, .capacity = inv.capacity });
+  std::sort(used.begin(), used.end(), [](const auto& a, const auto& b) { return a.offset < b.offset; });
+
+  uint32_t cursor = 0;
+  for (const InventoryRange& range : used) {
+    if (range.offset > cursor)
+      pool.free.push_back({ .offset = cursor, .capacity = range.offset - cursor });
+    cursor = std::max(cursor, range.offset + range.capacity);
+  }
+  if (cursor < (uint32_t)pool.slots.size())
+    pool.free.push_back({ .offset = cursor, .capacity = (uint32_t)pool.slots.size() - cursor });
+};
+
+// first fit. what is left of the range stays free
+static uint32_t
+allocate_range(InventoryPool& pool, const uint32_t capacity)
+{
+  for (size_t i = 0; i < pool.free.size(); i++) {
+    InventoryRange& range = pool.free[i];
+    if (range.capacity < capacity)
+      continue;
+    const uint32_t offset = range.offset;
+    range.offset += capacity;
+    range.capacity -= capacity;
+    if (range.capacity == 0)
+      pool.free.erase(pool.free.begin() + (ptrdiff_t)i);
+    return offset;
+  }
+
+  const auto offset = (uint32_t)pool.slots.size();
+  pool.slots.resize(pool.slots.size() + capacity, ITEM_NONE);
+  return offset;
+};
+
+void
+create_inventories(Registry& r,
+                   std::span<const entt::entity> entities,
+                   const uint16_t capacity,
+                   const uint16_t count,
+                   const ItemId item,
+                   std::pmr::memory_resource* scratch)
+{
+  const size_t n = entities.size();
+  if (n == 0)
+    return;
+  InventoryPool& pool = get_inventory_pool(r);
+  const uint16_t start_count = std::min(count, capacity);
+
+  // one block for the whole batch
+  const uint32_t block = allocate_range(pool, (uint32_t)(n * capacity));
+
+  std::pmr::vector<InventoryComponent> inventories(n, scratch);
+  for (size_t i = 0; i < n; i++) {
+    InventoryComponent& inv = inventories[i];
+    inv.offset = block + (uint32_t)(i * capacity);
+    inv.capacity = capacity;
+    inv.count = start_count;
+    std::fill_n(pool.slots.begin() + inv.offset, start_count, item);
+    std::fill_n(pool.slots.begin() + inv.offset + start_count, capacity - start_count, ITEM_NONE);
+  }
+
+  auto& storage = r.storage<InventoryComponent>();
+  storage.reserve(storage.size() + n);
+  r.insert<InventoryComponent>(entities.begin(), entities.end(), inventories.begin());
+};
+
+std::span<const ItemId>
+get_items(const InventoryPool& pool, const InventoryComponent& inv)
+{
+  return { pool.slots.data() + inv.offset, inv.count };
+};
+
+uint16_t
+transfer_items(InventoryPool& pool, InventoryComponent& from, InventoryComponent& to, const uint16_t n)
+{
+  const uint16_t space = to.capacity - to.count;
+  const uint16_t moved = std::min({ n, from.count, space });
+  if (moved == 0)
+    return 0;
+
+  // ranges never overlap
+  ItemId* src = pool.slots.data() + from.offset + (from.count - moved);
+  ItemId* dst = pool.slots.data() + to.offset + to.count;
+  SDL_memcpy(dst, src, sizeof(ItemId) * moved);
+  std::fill_n(src, moved, ITEM_NONE);
+
+  from.count -= moved;
+  to.count += moved;
+  return moved;
+};
+
+void
+apply_inventory_transfers(Registry& r, std::span<InventoryTransfer> transfers)
+{
+  InventoryPool& pool = get_inventory_pool(r);
+
+  for (InventoryTransfer& t : transfers) {
+    t.moved = 0;
+    if (t.from == t.to || !r.valid(t.from) || !r.valid(t.to))
+      continue;
+    auto* from = r.try_get<InventoryComponent>(t.from);
+    auto* to = r.try_get<InventoryComponent>(t.to);
+    if (from == nullptr || to == nullptr)
+      continue;
+
+    t.moved = transfer_items(pool, *from, *to, t.n);
+    if (t.moved == 0)
+      continue;
+    r.patch<InventoryComponent>(t.from);
+    r.patch<InventoryComponent>(t.to);
+  }
+};
+
+} // namespace game2d
@@ -0,0 +1,85 @@
+#pragma once
+
+#include "core/common.hpp"
+
+#include <entt/fwd.hpp>
+
+#include <memory_resource>
+#include <span>
+#include <vector>
+
+namespace game2d {
+
+using ItemId = uint32_t;
+constexpr ItemId ITEM_NONE = 0;
+constexpr ItemId ITEM_CRATE = 1;
+
+// a run of slots no inventory is using
+struct InventoryRange
+{
+  uint32_t offset = 0;
+  uint32_t capacity = 0;
+};
+
+// Every inventory's items, in one array.
+// Each InventoryComponent owns a fixed range of slots,
+// so inventories created together sit next to each other.
+// Lives in the registry's context, see get_inventory_pool().
+struct InventoryPool
+{
+  std::vector<ItemId> slots;
+
+  // released ranges, sorted by offset. neighbours are merged,
+  // and a range at the end is given back by shrinking slots
+  std::vector<InventoryRange> free;
+};
+
+// moves up to n items from the end of one inventory to the end of another
+struct InventoryTransfer
+{
+  entt::entity from = entt::null;
+  entt::entity to = entt::null;
+  uint16_t n = 1;
+  uint16_t moved = 0; // set by apply_inventory_transfers()
+};
+
+// creates the pool, and releases slots when an InventoryComponent is destroyed
+void
+init_inventory_pool(Registry& r);
+
+InventoryPool&
+get_inventory_pool(Registry& r);
+
+// forget every range, e.g. after the registry is cleared
+void
+clear_inventory_pool(Registry& r);
+
+// after the slots are restored in bulk (e.g. from a snapshot),
+// anything between the inventories is free
+void
+rebuild_inventory_free_ranges(Registry& r);
+
+// emplaces an InventoryComponent on each entity.
+// the ranges are allocated as one block, and the first count slots are set to item.
+// scratch is for the temporary components, e.g. frame_resource() on the gamethread.
+void
+create_inventories(Registry& r,
+                   std::span<const entt::entity> entities,
+                   const uint16_t capacity,
+                   const uint16_t count,
+                   const ItemId item = ITEM_CRATE,
+                   std::pmr::memory_resource* scratch = std::pmr::get_default_resource());
+
+std::span<const ItemId>
+get_items(const InventoryPool& pool, const InventoryComponent& inv);
+
+// O(n) in the items moved, not in the size of either inventory.
+// returns the number of items moved.
+uint16_t
+transfer_items(InventoryPool& pool, InventoryComponent& from, InventoryComponent& to, const uint16_t n);
+
+// applies the transfers in order. each inventory is patch()ed, so listeners see the change.
+void
+apply_inventory_transfers(Registry& r, std::span<InventoryTransfer> transfers);
+
+} // namespace game2d
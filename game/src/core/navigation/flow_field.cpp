@@ -0,0 +1,337 @@
+#include "core/pch.hpp"
+
+#include "flow_field.hpp"
+
+#include <cmath>
+
+namespace game2d {
+
+static bool
+is_goal(const FlowField& field, const int index)
+{
+  return std::find(field.goals.begin(), field.goals.end(), index) != field.goals.end();
+};
+
+// a min heap of (integration, index) packed in one integer
+static void
+push_open(FlowField& field, const uint32_t integration, const int index)
+{
+  field.open.push_back(((uint64_t)integration << 32) | (uint32_t)index);
+  std::push_heap(field.open.begin(), field.open.end(), std::greater<>{});
+};
+
+static void
+run_dijkstra(FlowField& field, const bool track)
+{
+  while (!field.open.empty()) {
+    std::pop_heap(field.open.begin(), field.open.end(), std::greater<>{});
+    const uint64_t top = field.open.back();
+    field.open.pop_back();
+
+    const auto d = (uint32_t)(top >> 32);
+    const auto index = (int)(uint32_t)top;
+    if (d > field.integration[index])
+      continue; // stale
+
+    const ivec2 gp = index_to_grid_position(index, field.width);
+    for (size_t i = 0; i < 4; i++) {
+      const ivec2 np = { gp.x + GRID_NEIGHBOURS[i].x, gp.y + GRID_NEIGHBOURS[i].y };
+      if (!grid_position_in_bounds(np, field.width, field.height))
+        continue;
+      const int n = grid_position_to_index(np, field.width);
+      if (field.costs[n] == FLOW_COST_WALL)
+        continue;
+
+      const uint32_t nd = d + field.costs[n];
+      if (nd < field.integration[n]) {
+        field.integration[n] = nd;
+        push_open(field, nd, n);
+        if (track)
+          field.touched.push_back(n);
+      }
+    }
+  }
+};
+
+static bool
+is_walkable(const FlowField& field, const ivec2 gp)
+{
+  return grid_position_in_bounds(gp, field.width, field.height) &&
+         field.costs[grid_position_to_index(gp, field.width)] != FLOW_COST_WALL;
+};
+
+// points at the cheapest neighbour. diagonals cant cut past a wall.
+static vec2
+compute_direction(const FlowField& field, const int index)
+{
+  const uint32_t here = field.integration[index];
+  if (here == 0 || here == FLOW_UNREACHABLE || field.costs[index] == FLOW_COST_WALL)
+    return { 0, 0 };
+
+  const ivec2 gp = index_to_grid_position(index, field.width);
+  uint32_t best = here;
+  ivec2 best_offset{ 0, 0 };
+  for (size_t i = 0; i < GRID_NEIGHBOURS.size(); i++) {
+    const ivec2 o = GRID_NEIGHBOURS[i];
+    const ivec2 np = { gp.x + o.x, gp.y + o.y };
+    if (!is_walkable(field, np))
+      continue;
+    if (i >= 4 && (!is_walkable(field, { gp.x + o.x, gp.y }) || !is_walkable(field, { gp.x, gp.y + o.y })))
+      continue;
+
+    const uint32_t d = field.integration[grid_position_to_index(np, field.width)];
+    if (d < best) {
+      best = d;
+      best_offset = o;
+    }
+  }
+
+  if (best_offset == ivec2{ 0, 0 })
+    return { 0, 0 };
+  const float inv_len = 1.0f / std::sqrt((float)(best_offset.x * best_offset.x + best_offset.y * best_offset.y));
+  return { (float)best_offset.x * inv_len, (float)best_offset.y * inv_len };
+};
+
+static void
+compute_directions(FlowField& field, SystemContext& ctx, std::span<const int> indices)
+{
+  parallel_for(ctx, (uint32_t)indices.size(), 1024, [&field, indices](uint32_t start, uint32_t end) {
+    for (uint32_t i = start; i < end; i++)
+      field.directions[indices[i]] = compute_direction(field, indices[i]);
+  });
+};
+
+static void
+rebuild_flow_field(FlowField& field, SystemContext& ctx)
+{
+  for (const FlowTileChange& change : field.changed)
+    field.costs[change.index] = change.cost;
+  field.changed.clear();
+
+  const int n = field.width * field.height;
+  field.integration.assign(n, FLOW_UNREACHABLE);
+  field.open.clear();
+  for (const int goal : field.goals) {
+    if (field.costs[goal] == FLOW_COST_WALL)
+      continue;
+    field.integration[goal] = 0;
+    push_open(field, 0, goal);
+  }
+  run_dijkstra(field, false);
+
+  parallel_for(ctx, (uint32_t)n, 1024, [&field](uint32_t start, uint32_t end) {
+    for (uint32_t i = start; i < end; i++)
+      field.directions[i] = compute_direction(field, (int)i);
+  });
+
+  field.dirty = false;
+  field.n_rebuilds++;
+  field.last_touched = (uint32_t)n;
+};
+
+// the tile got cheaper, so only tiles reached through it can improve
+static void
+lower_tile(FlowField& field, const int index)
+{
+  uint32_t best = FLOW_UNREACHABLE;
+  if (is_goal(field, index))
+    best = 0;
+  else {
+    const ivec2 gp = index_to_grid_position(index, field.width);
+    for (size_t i = 0; i < 4; i++) {
+      const ivec2 np = { gp.x + GRID_NEIGHBOURS[i].x, gp.y + GRID_NEIGHBOURS[i].y };
+      if (!is_walkable(field, np))
+        continue;
+      const uint32_t d = field.integration[grid_position_to_index(np, field.width)];
+      if (d != FLOW_UNREACHABLE)
+        best = std::min(best, d + field.costs[index]);
+    }
+  }
+
+  field.touched.push_back(index); // neighbours could now step through it
+  if (best < field.integration[index]) {
+    field.integration[index] = best;
+    push_open(field, best, index);
+    run_dijkstra(field, true);
+  }
+};
+
+// the tile got dearer. every tile whose path could go through it is cleared,
+// then refilled from the tiles around them.
+static void
+raise_tile(FlowField& field, const int index)
+{
+  if (field.integration[index] == FLOW_UNREACHABLE)
+    return;
+
+  // the tiles that depend on this one, found with the integration before the change
+  std::vector<int>& region = field.stack;
+  region.clear();
+  region.push_back(index);
+  field.marks[index] = 1;
+  for (size_t r = 0; r < region.size(); r++) {
+    const int x = region[r];
+    const ivec2 gp = index_to_grid_position(x, field.width);
+    for (size_t i = 0; i < 4; i++) {
+      const ivec2 np = { gp.x + GRID_NEIGHBOURS[i].x, gp.y + GRID_NEIGHBOURS[i].y };
+      if (!grid_position_in_bounds(np, field.width, field.height))
+        continue;
+      const int m = grid_position_to_index(np, field.width);
+      if (field.marks[m] || field.integration[m] == FLOW_UNREACHABLE || field.costs[m] == FLOW_COST_WALL)
+        continue;
+      if (field.integration[m] == field.integration[x] + field.costs[m]) {
+        field.marks[m] = 1;
+        region.push_back(m);
+      }
+    }
+  }
+
+  for (const int x : region) {
+    field.integration[x] = FLOW_UNREACHABLE;
+    field.touched.push_back(x);
+  }
+
+  // seed from the tiles outside the region
+  for (const int x : region) {
+    if (field.costs[x] == FLOW_COST_WALL)
+      continue;
+
+    uint32_t best = FLOW_UNREACHABLE;
+    if (is_goal(field, x))
+      best = 0;
+    else {
+      const ivec2 gp = index_to_grid_position(x, field.width);
+      for (size_t i = 0; i < 4; i++) {
+        const ivec2 np = { gp.x + GRID_NEIGHBOURS[i].x, gp.y + GRID_NEIGHBOURS[i].y };
+        if (!grid_position_in_bounds(np, field.width, field.height))
+          continue;
+        const int m = grid_position_to_index(np, field.width);
+        if (field.marks[m] || field.integration[m] == FLOW_UNREACHABLE)
+          continue;
+        best = std::min(best, field.integration[m] + field.costs[x]);
+      }
+    }
+    if (best != FLOW_UNREACHABLE) {
+      field.integration[x] = best;
+      push_open(field, best, x);
+    }
+  }
+
+  for (const int x : region)
+    field.marks[x] = 0;
+
+  run_dijkstra(field, true);
+};
+
+void
+init_flow_field(FlowField& field, const int width, const int height, const int cell_size, const vec2 origin)
+{
+  const int n = width * height;
+  field.width = width;
+  field.height = height;
+  field.cell_size = cell_size;
+  field.origin = origin;
+  field.costs.assign(n, FLOW_COST_OPEN);
+  field.integration.assign(n, FLOW_UNREACHABLE);
+  field.directions.assign(n, vec2{ 0, 0 });
+  field.marks.assign(n, 0);
+  field.goals.clear();
+  field.changed.clear();
+  field.dirty = true;
+};
+
+void
+set_flow_goals(FlowField& field, std::span<const int> goals)
+{
+  field.goals.assign(goals.begin(), goals.end());
+  field.dirty = true;
+};
+
+void
+set_flow_cost(FlowField& field, const int index, const uint8_t cost)
+{
+  assert(cost > 0);
+  field.changed.push_back({ .index = index, .cost = cost });
+};
+
+void
+update_flow_field(FlowField& field, SystemContext& ctx)
+{
+  if (field.width == 0 || field.height == 0)
+    return;
+
+  const size_t n = field.costs.size();
+  if (field.dirty || (float)field.changed.size() > FLOW_MAX_INCREMENTAL_FRACTION * (float)n) {
+    rebuild_flow_field(field, ctx);
+    return;
+  }
+
+  field.last_touched = 0;
+  if (field.changed.empty())
+    return;
+
+  // one change at a time, so the field is consistent before each
+  field.touched.clear();
+  field.open.clear();
+  for (const FlowTileChange& change : field.changed) {
+    const uint8_t old_cost = field.costs[change.index];
+    field.costs[change.index] = change.cost;
+    if (change.cost < old_cost)
+      lower_tile(field, change.index);
+    else if (change.cost > old_cost)
+      raise_tile(field, change.index);
+  }
+  field.changed.clear();
+
+  // a tile's direction depends on its neighbours
+  std::vector<int>& dirty = field.stack;
+  dirty.clear();
+  for (const int index : field.touched) {
+    const ivec2 gp = index_to_grid_position(index, field.width);
+    dirty.push_back(index);
+    for (const ivec2 o : GRID_NEIGHBOURS) {
+      const ivec2 np = { gp.x + o.x, gp.y + o.y };
+      if (grid_position_in_bounds(np, field.width, field.height))
+        dirty.push_back(grid_position_to_index(np, field.width));
+    }
+  }
+  std::sort(dirty.begin(), dirty.end());
+  dirty.erase(std::unique(dirty.begin(), dirty.end()), dirty.end());
+  compute_directions(field, ctx, dirty);
+
+  field.n_incremental++;
+  field.last_touched = (uint32_t)dirty.size();
+};
+
+int
+flow_field_index(const FlowField& field, const vec2 world_pos)
+{
+  const ivec2 gp = world_position_to_grid_position(world_pos - field.origin, field.cell_size);
+  if (!grid_position_in_bounds(gp, field.width, field.height))
+    return -1;
+  return grid_position_to_index(gp, field.width);
+};
+
+bool
+flow_field_rect_tiles(const FlowField& field, const vec2 pos, const vec2 size, ivec2& min, ivec2& max)
+{
+  const float cell = (float)field.cell_size;
+  const vec2 lo = pos - field.origin;
+  const vec2 hi = lo + size;
+  min.x = std::max((int)std::floor(lo.x / cell), 0);
+  min.y = std::max((int)std::floor(lo.y / cell), 0);
+  max.x = std::min((int)std::ceil(hi.x / cell) - 1, field.width - 1);
+  max.y = std::min((int)std::ceil(hi.y / cell) - 1, field.height - 1);
+  return min.x <= max.x && min.y <= max.y;
+};
+
+vec2
+sample_flow_field(const FlowField& field, const vec2 world_pos)
+{
+  const int index = flow_field_index(field, world_pos);
+  if (index < 0)
+    return { 0, 0 };
+  return field.directions[index];
+};
+
+} // namespace game2d
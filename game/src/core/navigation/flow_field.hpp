@@ -0,0 +1,90 @@
+#pragma once
+
+#include "core/maths/grid.hpp"
+#include "core/scheduler/scheduler.hpp"
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+//
+// A flow field over a tile grid, so any number of agents can seek the same goals.
+// The integration field is the cost to reach the nearest goal, from a Dijkstra
+// over the 4 orthogonal neighbours. The vector field points each tile at its
+// cheapest of 8 neighbours. Agents sample one tile instead of each running A*.
+//
+// Changing tiles queues an incremental update: only the tiles whose cost to
+// the goal changes are recomputed. Changing the goals rebuilds everything.
+//
+
+namespace game2d {
+
+constexpr uint8_t FLOW_COST_OPEN = 1;
+constexpr uint8_t FLOW_COST_WALL = 255; // never entered
+constexpr uint32_t FLOW_UNREACHABLE = UINT32_MAX;
+
+// more changes than this (as a fraction of the tiles) rebuild instead
+constexpr float FLOW_MAX_INCREMENTAL_FRACTION = 0.1f;
+
+struct FlowTileChange
+{
+  int index = 0;
+  uint8_t cost = FLOW_COST_OPEN;
+};
+
+struct FlowField
+{
+  int width = 0;
+  int height = 0;
+  int cell_size = 32;
+  vec2 origin{ 0, 0 }; // world position of tile 0,0
+
+  std::vector<uint8_t> costs;        // to enter a tile, 1 to 254
+  std::vector<uint32_t> integration; // to reach a goal
+  std::vector<vec2> directions;      // unit vectors. zero on goals, walls and unreachable tiles
+  std::vector<int> goals;
+
+  std::vector<FlowTileChange> changed; // applied one at a time by the next update
+  bool dirty = true;                   // rebuild everything
+
+  // scratch
+  std::vector<uint64_t> open; // heap of (integration << 32 | index)
+  std::vector<uint8_t> marks;
+  std::vector<int> touched;
+  std::vector<int> stack;
+
+  // stats
+  uint32_t n_rebuilds = 0;
+  uint32_t n_incremental = 0;
+  uint32_t last_touched = 0; // tiles recomputed by the last update
+};
+
+void
+init_flow_field(FlowField& field, const int width, const int height, const int cell_size, const vec2 origin);
+
+// rebuilds on the next update
+void
+set_flow_goals(FlowField& field, std::span<const int> goals);
+
+// queues an incremental update. costs is not changed until then.
+void
+set_flow_cost(FlowField& field, const int index, const uint8_t cost);
+
+// the dijkstra is serial, the vector field is split over the job system
+void
+update_flow_field(FlowField& field, SystemContext& ctx);
+
+int
+flow_field_index(const FlowField& field, const vec2 world_pos);
+
+// the tiles a rect covers, clamped to the field. max is inclusive, but the rect's
+// far edge is not: a rect ending on a tile boundary does not cover the next tile.
+// false if it covers none.
+bool
+flow_field_rect_tiles(const FlowField& field, const vec2 pos, const vec2 size, ivec2& min, ivec2& max);
+
+// zero outside the field
+vec2
+sample_flow_field(const FlowField& field, const vec2 world_pos);
+
+} // namespace game2d
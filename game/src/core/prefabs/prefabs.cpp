@@ -0,0 +1,231 @@
+#include "core/pch.hpp"
+
+#include "prefabs.hpp"
+
+#include "actors/actor_player/actor_player_components.hpp"
+#include "core/inventory/inventory_pool.hpp"
+#include "core/spawn/spawn_helpers.hpp"
+#include "systems/system_flow_field/flow_field_components.hpp"
+#include "systems/system_items/items_components.hpp"
+#include "systems/system_particles/particles_components.hpp"
+#include "systems/system_physics_activity/physics_activity_components.hpp"
+
+#include <nlohmann/json.hpp>
+
+namespace game2d {
+
+using json = nlohmann::json;
+
+template<typename T>
+static void
+insert_component(Registry& r, std::span<const entt::entity> entities, const std::byte* value, std::pmr::memory_resource*)
+{
+  // one reservation per pool per batch
+  auto& storage = r.storage<T>();
+  storage.reserve(storage.size() + entities.size());
+  r.insert<T>(entities.begin(), entities.end(), *reinterpret_cast<const T*>(value));
+};
+
+// the blueprint's capacity and count, with slots from the pool
+static void
+insert_inventories(Registry& r,
+                   std::span<const entt::entity> entities,
+                   const std::byte* value,
+                   std::pmr::memory_resource* scratch)
+{
+  const auto& inv = *reinterpret_cast<const InventoryComponent*>(value);
+  create_inventories(r, entities, inv.capacity, inv.count, ITEM_CRATE, scratch);
+};
+
+template<typename T>
+static void
+add_component(Prefab& prefab, const T& value, prefab_insert_func_t insert = &insert_component<T>)
+{
+  static_assert(std::is_trivially_copyable_v<T>);
+  const size_t offset = (prefab.values.size() + alignof(T) - 1) & ~(alignof(T) - 1);
+  prefab.values.resize(offset + sizeof(T));
+  SDL_memcpy(prefab.values.data() + offset, &value, sizeof(T));
+  prefab.components.push_back({ .insert = insert, .offset = (uint32_t)offset });
+};
+
+static vec2
+parse_vec2(const json& j, const vec2 fallback)
+{
+  if (!j.is_array() || j.size() != 2)
+    return fallback;
+  return { j[0].get<float>(), j[1].get<float>() };
+};
+
+static ColourComponent
+parse_colour(const json& j)
+{
+  ColourComponent c;
+  if (!j.is_array() || j.size() < 3)
+    return c;
+  c.r = j[0].get<float>();
+  c.g = j[1].get<float>();
+  c.b = j[2].get<float>();
+  c.a = j.size() > 3 ? j[3].get<float>() : 1.0f;
+  return c;
+};
+
+static void
+compile_component(Prefab& prefab, const std::string& key, const json& j)
+{
+  if (key == "colour")
+    add_component(prefab, parse_colour(j));
+  else if (key == "inventory") {
+    InventoryComponent inv;
+    inv.capacity = j.value("capacity", (uint16_t)8);
+    inv.count = j.value("items", (uint16_t)0);
+    add_component(prefab, inv, &insert_inventories);
+  }
+  else if (key == "player")
+    add_component(prefab, PlayerComponent{});
+  else if (key == "container_provider")
+    add_component(prefab, ContainerProviderComponent{});
+  else if (key == "container_receiver")
+    add_component(prefab, ContainerReceiverComponent{});
+  else if (key == "point_of_interest")
+    add_component(prefab, PointOfInterestComponent{});
+  else if (key == "nav_obstacle")
+    add_component(prefab, NavObstacleComponent{});
+  else if (key == "flow_agent") {
+    FlowAgentComponent agent_c;
+    agent_c.speed = j.value("speed", agent_c.speed);
+    add_component(prefab, agent_c);
+  }
+  else if (key == "particle_emitter") {
+    ParticleEmitterComponent emitter_c;
+    emitter_c.particles_per_second = j.value("particles_per_second", emitter_c.particles_per_second);
+    emitter_c.desc.lifetime_min = j.value("lifetime_min", emitter_c.desc.lifetime_min);
+    emitter_c.desc.lifetime_max = j.value("lifetime_max", emitter_c.desc.lifetime_max);
+    emitter_c.desc.size = j.value("size", emitter_c.desc.size);
+    if (j.contains("colour"))
+      emitter_c.desc.colour = parse_colour(j["colour"]);
+    add_component(prefab, emitter_c);
+  } else
+    throw std::runtime_error("prefab " + prefab.name + ": unknown component " + key);
+};
+
+static Prefab
+compile_prefab(const json& j)
+{
+  Prefab prefab;
+  prefab.name = j.at("name").get<std::string>();
+  prefab.size = parse_vec2(j.value("size", json{}), prefab.size);
+
+  if (j.contains("body")) {
+    const json& body = j["body"];
+    prefab.has_body = true;
+    prefab.is_static = body.value("static", false);
+    prefab.is_sensor = body.value("sensor", false);
+  }
+
+  // a renderable needs a colour
+  if (!j.contains("components") || !j["components"].contains("colour"))
+    add_component(prefab, ColourComponent{});
+
+  if (j.contains("components")) {
+    for (const auto& [key, value] : j["components"].items())
+      compile_component(prefab, key, value);
+  }
+
+  return prefab;
+};
+
+void
+parse_prefabs(PrefabLibrary& library, std::string_view text)
+{
+  const json root = json::parse(text.begin(), text.end(), nullptr, false);
+  if (root.is_discarded() || !root.contains("prefabs"))
+    throw std::runtime_error("prefabs: not valid json");
+
+  library.prefabs.clear();
+  library.by_name.clear();
+  try {
+    for (const json& j : root["prefabs"])
+      library.prefabs.push_back(compile_prefab(j));
+  } catch (const json::exception& e) {
+    throw std::runtime_error(std::string("prefabs: ") + e.what());
+  }
+
+  // the first prefab with a name wins
+  for (size_t i = 0; i < library.prefabs.size(); i++)
+    library.by_name.try_emplace(library.prefabs[i].name, (uint32_t)i);
+};
+
+void
+load_prefabs(PrefabLibrary& library, const char* path)
+{
+  size_t size = 0;
+  void* data = SDL_LoadFile(path, &size);
+  if (data == nullptr)
+    throw std::runtime_error(std::string("Failed to load prefabs: ") + path);
+
+  try {
+    parse_prefabs(library, std::string_view((const char*)data, size));
+  } catch (...) {
+    SDL_free(data);
+    throw;
+  }
+  SDL_free(data);
+  SDL_Log("loaded %zu prefabs from %s", library.prefabs.size(), path);
+};
+
+const Prefab&
+get_prefab(const PrefabLibrary& library, std::string_view name)
+{
+  const auto it = library.by_name.find(name);
+  if (it == library.by_name.end())
+    throw std::runtime_error("No prefab named " + std::string(name));
+  return library.prefabs[it->second];
+};
+
+void
+spawn_prefab_batch(Registry& r,
+                   const b2WorldId world_id,
+                   const Prefab& prefab,
+                   std::span<const vec2> positions,
+                   std::span<entt::entity> out,
+                   std::pmr::memory_resource* scratch)
+{
+  const size_t n = out.size();
+  assert(positions.size() == n);
+  if (n == 0)
+    return;
+
+  std::pmr::vector<TransformComponent> transforms(n, scratch);
+
+  auto& transform_storage = r.storage<TransformComponent>();
+  transform_storage.reserve(transform_storage.size() + n);
+
+  r.create(out.begin(), out.end());
+
+  for (size_t i = 0; i < n; i++) {
+    TransformComponent& t_c = transforms[i];
+    t_c.size = prefab.size;
+    t_c.pos = positions[i] - (0.5f * prefab.size);
+    t_c.rotation_radians = 0.0f;
+  }
+  r.insert<TransformComponent>(out.begin(), out.end(), transforms.begin());
+
+  // tags go in before the bodies, so the collision filters see them
+  for (const PrefabComponent& c : prefab.components)
+    c.insert(r, out, prefab.values.data() + c.offset, scratch);
+
+  if (prefab.has_body) {
+    const std::pmr::vector<vec2> sizes(n, prefab.size, scratch);
+    attach_bodies_batch(r, world_id, out, positions, sizes, {}, prefab.is_static, prefab.is_sensor, scratch);
+  }
+};
+
+entt::entity
+spawn_prefab(Registry& r, const b2WorldId world_id, const Prefab& prefab, const vec2 pos)
+{
+  entt::entity e = entt::null;
+  spawn_prefab_batch(r, world_id, prefab, { &pos, 1 }, { &e, 1 });
+  return e;
+};
+
+} // namespace game2d
@@ -0,0 +1,99 @@
+#pragma once
+
+#include "core/common.hpp"
+
+#include <box2d/box2d.h>
+#include <entt/fwd.hpp>
+
+#include <memory_resource>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+//
+// Prefabs are read from json once, and compiled to a blueprint:
+// a copy of each component's value, and a function that inserts it.
+// Spawning copies the blueprint in to the pools, a pool at a time.
+//
+// {
+//   "prefabs": [
+//     {
+//       "name": "player",
+//       "size": [50, 50],
+//       "body": { "static": false, "sensor": true },
+//       "components": { "colour": [0, 0, 1, 1], "player": {}, "inventory": { "capacity": 8, "items": 0 } }
+//     }
+//   ]
+// }
+//
+
+namespace game2d {
+
+// inserts value for every entity. scratch is for anything temporary
+using prefab_insert_func_t = void (*)(Registry& r,
+                                      std::span<const entt::entity> entities,
+                                      const std::byte* value,
+                                      std::pmr::memory_resource* scratch);
+
+struct PrefabComponent
+{
+  prefab_insert_func_t insert = nullptr;
+  uint32_t offset = 0; // in to Prefab::values
+};
+
+struct Prefab
+{
+  std::string name;
+  vec2 size{ 50, 50 }; // pixels
+
+  bool has_body = false;
+  bool is_static = false;
+  bool is_sensor = false;
+
+  std::vector<PrefabComponent> components;
+  std::vector<std::byte> values;
+};
+
+// lets the name index be searched with a string_view
+struct PrefabNameHash
+{
+  using is_transparent = void;
+  size_t operator()(std::string_view name) const { return std::hash<std::string_view>{}(name); };
+};
+
+struct PrefabLibrary
+{
+  std::vector<Prefab> prefabs;
+  std::unordered_map<std::string, uint32_t, PrefabNameHash, std::equal_to<>> by_name; // in to prefabs
+};
+
+// throws if the file is missing or not valid
+void
+load_prefabs(PrefabLibrary& library, const char* path);
+
+void
+parse_prefabs(PrefabLibrary& library, std::string_view json);
+
+// throws if there is no prefab with that name.
+// a hash lookup. callers that spawn every tick should keep the reference,
+// it stays valid until the library is parsed again
+const Prefab&
+get_prefab(const PrefabLibrary& library, std::string_view name);
+
+// positions are the centre of each instance, in pixels.
+// out must be the same length as positions.
+// scratch is for the temporary arrays, e.g. frame_resource() on the gamethread.
+void
+spawn_prefab_batch(Registry& r,
+                   const b2WorldId world_id,
+                   const Prefab& prefab,
+                   std::span<const vec2> positions,
+                   std::span<entt::entity> out,
+                   std::pmr::memory_resource* scratch = std::pmr::get_default_resource());
+
+entt::entity
+spawn_prefab(Registry& r, const b2WorldId world_id, const Prefab& prefab, const vec2 pos);
+
+} // namespace game2d
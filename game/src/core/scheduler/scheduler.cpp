@@ -0,0 +1,165 @@
+#include "core/pch.hpp"
+
+#include "core/scheduler/scheduler.hpp"
+
+namespace game2d {
+
+template<class F>
+static void
+run_range(uint32_t start, uint32_t end, uint32_t thread, void* user)
+{
+  (*static_cast<F*>(user))(start, end);
+};
+
+template<class F>
+static void*
+enqueue(JobSystem& jobs, const uint32_t n, const uint32_t min_range, F& fn)
+{
+  return jobs.enqueue(&run_range<F>, n, min_range, &fn, jobs.ctx);
+};
+
+static bool
+overlaps(const std::vector<entt::id_type>& a, const std::vector<entt::id_type>& b)
+{
+  for (const entt::id_type id : a)
+    if (std::find(b.begin(), b.end(), id) != b.end())
+      return true;
+  return false;
+};
+
+static bool
+conflicts(const SystemDesc& a, const SystemDesc& b)
+{
+  if (a.structural || b.structural)
+    return true;
+  return overlaps(a.access.writes, b.access.reads) || overlaps(a.access.writes, b.access.writes) ||
+         overlaps(a.access.reads, b.access.writes);
+};
+
+static void
+run_system(SystemSchedule& schedule, SystemContext& ctx, const int index)
+{
+  const uint64_t start = SDL_GetTicksNS();
+  schedule.systems[index].fn(ctx);
+  schedule.stats[index].ns = SDL_GetTicksNS() - start;
+};
+
+void
+add_system(SystemSchedule& schedule, SystemDesc desc)
+{
+  schedule.systems.push_back(std::move(desc));
+  schedule.dirty = true;
+};
+
+void
+build_schedule(SystemSchedule& schedule)
+{
+  const int n = (int)schedule.systems.size();
+  schedule.stats.assign(n, SystemStats{});
+  schedule.batches.clear();
+
+  // a system goes in the batch after the last one it conflicts with,
+  // so conflicting systems keep their registration order.
+  for (int i = 0; i < n; i++) {
+    int batch = 0;
+    for (int j = 0; j < i; j++) {
+      if (conflicts(schedule.systems[j], schedule.systems[i]))
+        batch = std::max(batch, schedule.stats[j].batch + 1);
+    }
+    schedule.stats[i].batch = batch;
+
+    if (batch >= (int)schedule.batches.size())
+      schedule.batches.resize(batch + 1);
+    schedule.batches[batch].push_back(i);
+  }
+
+  schedule.dirty = false;
+};
+
+void
+run_schedule(SystemSchedule& schedule, SystemContext& ctx)
+{
+  if (schedule.dirty)
+    build_schedule(schedule);
+
+  for (const SystemDesc& desc : schedule.systems)
+    for (const auto assure : desc.access.assure)
+      assure(ctx.r);
+
+  schedule.critical_path_ns = 0;
+  const uint64_t start = SDL_GetTicksNS();
+
+  std::vector<int>& workers = schedule.workers;
+  for (const std::vector<int>& batch : schedule.batches) {
+    workers.clear();
+    for (const int i : batch) {
+      const SystemDesc& desc = schedule.systems[i];
+      if (!desc.main_thread && !desc.structural && ctx.jobs != nullptr)
+        workers.push_back(i);
+    }
+
+    auto run_workers = [&](uint32_t start, uint32_t end) {
+      for (uint32_t w = start; w < end; w++)
+        run_system(schedule, ctx, workers[w]);
+    };
+    void* job = nullptr;
+    if (!workers.empty())
+      job = enqueue(*ctx.jobs, (uint32_t)workers.size(), 1, run_workers);
+
+    // the rest run here while the workers go
+    for (const int i : batch) {
+      if (std::find(workers.begin(), workers.end(), i) == workers.end())
+        run_system(schedule, ctx, i);
+    }
+
+    if (job != nullptr)
+      ctx.jobs->finish(job, ctx.jobs->ctx);
+
+    // batches are barriers, so the slowest system in each is on the critical path
+    int slowest = batch.front();
+    for (const int i : batch) {
+      schedule.stats[i].critical = false;
+      if (schedule.stats[i].ns > schedule.stats[slowest].ns)
+        slowest = i;
+    }
+    schedule.stats[slowest].critical = true;
+    schedule.critical_path_ns += schedule.stats[slowest].ns;
+  }
+
+  schedule.total_ns = SDL_GetTicksNS() - start;
+};
+
+void
+parallel_for(SystemContext& ctx, const uint32_t n, const uint32_t min_range, const std::function<void(uint32_t, uint32_t)>& fn)
+{
+  if (n == 0)
+    return;
+
+  if (ctx.jobs == nullptr || n <= min_range) {
+    fn(0, n);
+    return;
+  }
+
+  auto run = [&fn](uint32_t start, uint32_t end) { fn(start, end); };
+  void* job = enqueue(*ctx.jobs, n, std::max(min_range, 1u), run);
+  if (job != nullptr)
+    ctx.jobs->finish(job, ctx.jobs->ctx);
+};
+
+void
+export_schedule_ui(const SystemSchedule& schedule, std::vector<SystemTimingUi>& out)
+{
+  out.resize(schedule.systems.size());
+  for (size_t i = 0; i < schedule.systems.size(); i++) {
+    const SystemDesc& desc = schedule.systems[i];
+    const SystemStats& stats = schedule.stats[i];
+    SystemTimingUi& ui = out[i];
+    SDL_strlcpy(ui.name, desc.name.c_str(), sizeof(ui.name));
+    ui.batch = stats.batch;
+    ui.ms = (float)(1e-6 * (double)stats.ns);
+    ui.critical = stats.critical;
+    ui.main_thread = desc.main_thread || desc.structural;
+  }
+};
+
+} // namespace game2d
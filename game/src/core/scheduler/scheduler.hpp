@@ -0,0 +1,106 @@
+#pragma once
+
+#include "core/common.hpp"
+
+#include <entt/entt.hpp>
+
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace game2d {
+
+struct SystemContext
+{
+  Registry& r;
+  GameData* data = nullptr;
+  JobSystem* jobs = nullptr; // nullptr runs everything on the calling thread
+};
+
+using SystemFn = std::function<void(SystemContext& ctx)>;
+
+// What a system touches. Components, or tag types standing in for
+// state outside the registry (e.g. the camera, the particle buffer).
+struct SystemAccess
+{
+  std::vector<entt::id_type> reads;
+  std::vector<entt::id_type> writes;
+
+  // views lazily create their storage, which is not thread safe.
+  // storage for every declared type is created before systems run in parallel.
+  std::vector<void (*)(Registry&)> assure;
+};
+
+template<class... T>
+struct Reads
+{};
+
+template<class... T>
+struct Writes
+{};
+
+template<class... R, class... W>
+SystemAccess
+make_access(Reads<R...>, Writes<W...>)
+{
+  SystemAccess access;
+  access.reads = { entt::type_hash<R>::value()... };
+  access.writes = { entt::type_hash<W>::value()... };
+  access.assure = { +[](Registry& r) { r.storage<R>(); }..., +[](Registry& r) { r.storage<W>(); }... };
+  return access;
+};
+
+struct SystemDesc
+{
+  std::string name;
+  SystemFn fn;
+  SystemAccess access;
+
+  // calls in to SDL, box2d, or other state that is only safe on the gamethread
+  bool main_thread = false;
+
+  // creates/destroys entities or components. runs alone.
+  bool structural = false;
+};
+
+struct SystemStats
+{
+  uint64_t ns = 0;
+  int batch = 0;
+  bool critical = false; // the slowest system in its batch
+};
+
+// Systems run in registration order, except that systems with no conflicting
+// access are put in the same batch and run in parallel.
+// Two systems conflict if either writes something the other reads or writes.
+struct SystemSchedule
+{
+  std::vector<SystemDesc> systems;
+  std::vector<std::vector<int>> batches; // indices in to systems
+  std::vector<SystemStats> stats;
+  uint64_t critical_path_ns = 0;
+  uint64_t total_ns = 0;
+  bool dirty = true;
+
+  std::vector<int> workers; // scratch
+};
+
+void
+add_system(SystemSchedule& schedule, SystemDesc desc);
+
+// rebuilds the batches. called by run_schedule() when systems change.
+void
+build_schedule(SystemSchedule& schedule);
+
+void
+run_schedule(SystemSchedule& schedule, SystemContext& ctx);
+
+// Splits [0, n) in to ranges run on the job system, for chunking a view within a system.
+void
+parallel_for(SystemContext& ctx, const uint32_t n, const uint32_t min_range, const std::function<void(uint32_t, uint32_t)>& fn);
+
+// copies the last run's timings in to the ui data
+void
+export_schedule_ui(const SystemSchedule& schedule, std::vector<SystemTimingUi>& out);
+
+} // namespace game2d
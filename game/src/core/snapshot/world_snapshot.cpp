@@ -0,0 +1,455 @@
+#include "core/pch.hpp"
+
+#include "world_snapshot.hpp"
+
+#include "actors/actor_player/actor_player_components.hpp"
+#include "core/box2d/box2d_components.hpp"
+#include "core/box2d/box2d_helpers.hpp"
+#include "core/common.hpp"
+#include "core/inventory/inventory_pool.hpp"
+#include "core/io/mapped_file.hpp"
+#include "core/spawn/spawn_helpers.hpp"
+#include "systems/system_flow_field/flow_field_components.hpp"
+#include "systems/system_items/items_components.hpp"
+#include "systems/system_physics_activity/physics_activity_components.hpp"
+
+#include <bit>
+
+namespace game2d {
+
+// sections are copied to and from memory as they are
+static_assert(std::endian::native == std::endian::little);
+
+constexpr uint64_t SNAPSHOT_ALIGN = 16;
+
+template<typename T>
+constexpr SnapshotSection snapshot_section = SnapshotSection::COUNT;
+template<>
+constexpr SnapshotSection snapshot_section<TransformComponent> = SnapshotSection::TRANSFORM;
+template<>
+constexpr SnapshotSection snapshot_section<ColourComponent> = SnapshotSection::COLOUR;
+template<>
+constexpr SnapshotSection snapshot_section<InventoryComponent> = SnapshotSection::INVENTORY;
+template<>
+constexpr SnapshotSection snapshot_section<PlayerComponent> = SnapshotSection::PLAYER;
+template<>
+constexpr SnapshotSection snapshot_section<ContainerProviderComponent> = SnapshotSection::CONTAINER_PROVIDER;
+template<>
+constexpr SnapshotSection snapshot_section<ContainerReceiverComponent> = SnapshotSection::CONTAINER_RECEIVER;
+template<>
+constexpr SnapshotSection snapshot_section<PointOfInterestComponent> = SnapshotSection::POINT_OF_INTEREST;
+template<>
+constexpr SnapshotSection snapshot_section<NavObstacleComponent> = SnapshotSection::NAV_OBSTACLE;
+template<>
+constexpr SnapshotSection snapshot_section<FlowAgentComponent> = SnapshotSection::FLOW_AGENT;
+
+// sections written by a build with a different layout are rejected
+static uint32_t
+expected_elem_size(const SnapshotSection section)
+{
+  switch (section) {
+    case SnapshotSection::TRANSFORM:
+      return sizeof(TransformComponent);
+    case SnapshotSection::COLOUR:
+      return sizeof(ColourComponent);
+    case SnapshotSection::INVENTORY:
+      return sizeof(InventoryComponent);
+    case SnapshotSection::PLAYER:
+      return sizeof(PlayerComponent);
+    case SnapshotSection::CONTAINER_PROVIDER:
+      return sizeof(ContainerProviderComponent);
+    case SnapshotSection::CONTAINER_RECEIVER:
+      return sizeof(ContainerReceiverComponent);
+    case SnapshotSection::POINT_OF_INTEREST:
+      return sizeof(PointOfInterestComponent);
+    case SnapshotSection::NAV_OBSTACLE:
+      return sizeof(NavObstacleComponent);
+    case SnapshotSection::FLOW_AGENT:
+      return sizeof(FlowAgentComponent);
+    case SnapshotSection::PHYSICS_BODY:
+      return sizeof(SnapshotBody);
+    case SnapshotSection::INVENTORY_POOL:
+      return sizeof(ItemId);
+    default:
+      return 0;
+  }
+};
+
+static uint64_t
+align_up(const uint64_t offset)
+{
+  return (offset + SNAPSHOT_ALIGN - 1) & ~(SNAPSHOT_ALIGN - 1);
+};
+
+// an entt::basic_snapshot output archive.
+// a pool is collected as an array of ids and an array of components.
+struct SnapshotSectionArchive
+{
+  SnapshotSection section = SnapshotSection::COUNT;
+  uint32_t elem_size = 0;
+  bool per_entity = true;
+  std::vector<uint32_t> ids;
+  std::vector<std::byte> data;
+
+  void operator()(const std::underlying_type_t<entt::entity> count)
+  {
+    ids.reserve(count);
+    data.reserve((size_t)count * elem_size);
+  };
+
+  void operator()(const entt::entity e) { ids.push_back(entt::to_integral(e)); };
+
+  template<typename T>
+  void operator()(const T& c)
+  {
+    static_assert(std::is_trivially_copyable_v<T>);
+    const auto* bytes = reinterpret_cast<const std::byte*>(&c);
+    data.insert(data.end(), bytes, bytes + sizeof(T));
+  };
+};
+
+template<typename T>
+static void
+collect_section(const Registry& r, std::vector<SnapshotSectionArchive>& sections)
+{
+  SnapshotSectionArchive& archive = sections.emplace_back();
+  archive.section = snapshot_section<T>;
+  archive.elem_size = (uint32_t)sizeof(T);
+  entt::basic_snapshot<Registry>{ r }.get<T>(archive);
+};
+
+static void
+collect_bodies(const Registry& r, std::vector<SnapshotSectionArchive>& sections)
+{
+  SnapshotSectionArchive& archive = sections.emplace_back();
+  archive.section = SnapshotSection::PHYSICS_BODY;
+  archive.elem_size = (uint32_t)sizeof(SnapshotBody);
+
+  const auto view = r.view<const PhysicsBodyComponent>();
+  archive((std::underlying_type_t<entt::entity>)view.size());
+  for (const auto& [e, pb_c] : view.each()) {
+    const b2Vec2 center = b2Body_GetPosition(pb_c.id);
+    const b2Vec2 velocity = b2Body_GetLinearVelocity(pb_c.id);
+    const vec2 center_px = meters_to_pixels(center);
+    const vec2 size_px = meters_to_pixels(b2Sub(pb_c.local_aabb.upperBound, pb_c.local_aabb.lowerBound));
+
+    SnapshotBody body;
+    body.flags |= b2Body_GetType(pb_c.id) == b2_staticBody ? SNAPSHOT_BODY_STATIC : 0;
+    body.flags |= pb_c.n_shapes > 0 && b2Shape_IsSensor(pb_c.shape_ids[0]) ? SNAPSHOT_BODY_SENSOR : 0;
+    body.size_x = size_px.x;
+    body.size_y = size_px.y;
+    body.center_x = center_px.x;
+    body.center_y = center_px.y;
+    body.velocity_x = velocity.x;
+    body.velocity_y = velocity.y;
+    archive(e);
+    archive(body);
+  }
+};
+
+// inventories refer to ranges of the pool, so the pool is saved as it is
+static void
+collect_inventory_pool(const Registry& r, std::vector<SnapshotSectionArchive>& sections)
+{
+  SnapshotSectionArchive& archive = sections.emplace_back();
+  archive.section = SnapshotSection::INVENTORY_POOL;
+  archive.elem_size = (uint32_t)sizeof(ItemId);
+  archive.per_entity = false;
+
+  if (const auto* pool = r.ctx().find<InventoryPool>()) {
+    const auto* bytes = reinterpret_cast<const std::byte*>(pool->slots.data());
+    archive.data.assign(bytes, bytes + sizeof(ItemId) * pool->slots.size());
+  }
+};
+
+bool
+save_world_snapshot(const Registry& r, const char* path)
+{
+  const Uint64 start = SDL_GetTicksNS();
+
+  // the transform pool defines which entities are saved
+  std::vector<SnapshotSectionArchive> sections;
+  collect_section<TransformComponent>(r, sections);
+  collect_section<ColourComponent>(r, sections);
+  collect_section<InventoryComponent>(r, sections);
+  collect_section<PlayerComponent>(r, sections);
+  collect_section<ContainerProviderComponent>(r, sections);
+  collect_section<ContainerReceiverComponent>(r, sections);
+  collect_section<PointOfInterestComponent>(r, sections);
+  collect_section<NavObstacleComponent>(r, sections);
+  collect_section<FlowAgentComponent>(r, sections);
+  collect_bodies(r, sections);
+  collect_inventory_pool(r, sections);
+
+  // lay out the file
+  std::vector<SnapshotTocEntry> toc(sections.size());
+  uint64_t offset = align_up(sizeof(SnapshotHeader) + sizeof(SnapshotTocEntry) * toc.size());
+  for (size_t i = 0; i < sections.size(); i++) {
+    const SnapshotSectionArchive& s = sections[i];
+    SnapshotTocEntry& entry = toc[i];
+    entry.section = s.section;
+    entry.elem_size = s.elem_size;
+    entry.count = s.per_entity ? s.ids.size() : s.data.size() / s.elem_size;
+    entry.ids_offset = s.per_entity ? offset : 0;
+    offset = align_up(offset + sizeof(uint32_t) * s.ids.size());
+    entry.data_offset = offset;
+    offset = align_up(offset + s.data.size());
+  }
+
+  SnapshotHeader header;
+  header.n_sections = (uint32_t)toc.size();
+  header.file_size = offset;
+
+  std::vector<std::byte> bytes(offset);
+  SDL_memcpy(bytes.data(), &header, sizeof(header));
+  SDL_memcpy(bytes.data() + sizeof(header), toc.data(), sizeof(SnapshotTocEntry) * toc.size());
+  for (size_t i = 0; i < sections.size(); i++) {
+    if (toc[i].count == 0)
+      continue;
+    if (sections[i].per_entity)
+      SDL_memcpy(bytes.data() + toc[i].ids_offset, sections[i].ids.data(), sizeof(uint32_t) * sections[i].ids.size());
+    SDL_memcpy(bytes.data() + toc[i].data_offset, sections[i].data.data(), sections[i].data.size());
+  }
+
+  SDL_IOStream* io = SDL_IOFromFile(path, "wb");
+  if (io == nullptr) {
+    SDL_Log("save_world_snapshot(): failed to open %s: %s", path, SDL_GetError());
+    return false;
+  }
+  const bool ok = SDL_WriteIO(io, bytes.data(), bytes.size()) == bytes.size();
+  SDL_CloseIO(io);
+  if (!ok) {
+    SDL_Log("save_world_snapshot(): failed to write %s", path);
+    return false;
+  }
+
+  const float ms = (float)(1e-6 * (double)(SDL_GetTicksNS() - start));
+  SDL_Log("saved %zu entities (%zu bytes) to %s in %0.2fms", sections[0].ids.size(), bytes.size(), path, ms);
+  return true;
+};
+
+// a validated view of the mapped file
+struct SnapshotView
+{
+  std::span<const std::byte> bytes;
+  std::array<const SnapshotTocEntry*, (size_t)SnapshotSection::COUNT> sections{};
+
+  // saved entity index -> position in the transform section
+  std::vector<uint32_t> slots;
+};
+
+template<typename T>
+static const T*
+section_ptr(const SnapshotView& view, const uint64_t offset)
+{
+  return reinterpret_cast<const T*>(view.bytes.data() + offset);
+};
+
+static bool
+validate_snapshot(SnapshotView& view)
+{
+  const auto& bytes = view.bytes;
+  if (bytes.size() < sizeof(SnapshotHeader))
+    return false;
+
+  SnapshotHeader header;
+  SDL_memcpy(&header, bytes.data(), sizeof(header));
+  if (header.magic != SNAPSHOT_MAGIC || header.version != SNAPSHOT_VERSION || header.file_size != bytes.size())
+    return false;
+  if (sizeof(SnapshotHeader) + sizeof(SnapshotTocEntry) * (uint64_t)header.n_sections > bytes.size())
+    return false;
+
+  const auto* toc = section_ptr<SnapshotTocEntry>(view, sizeof(SnapshotHeader));
+  for (uint32_t i = 0; i < header.n_sections; i++) {
+    const SnapshotTocEntry& entry = toc[i];
+    if (entry.section >= SnapshotSection::COUNT || view.sections[(size_t)entry.section] != nullptr)
+      return false;
+    if (entry.elem_size != expected_elem_size(entry.section))
+      return false;
+    const bool per_entity = entry.section != SnapshotSection::INVENTORY_POOL;
+    if (per_entity != (entry.ids_offset != 0))
+      return false;
+    if (entry.ids_offset % SNAPSHOT_ALIGN != 0 || entry.data_offset % SNAPSHOT_ALIGN != 0)
+      return false;
+    if (entry.ids_offset > bytes.size() || entry.data_offset > bytes.size() || entry.count > bytes.size())
+      return false;
+    if (entry.ids_offset + sizeof(uint32_t) * entry.count > bytes.size())
+      return false;
+    if (entry.data_offset + (uint64_t)entry.elem_size * entry.count > bytes.size())
+      return false;
+    view.sections[(size_t)entry.section] = &entry;
+  }
+
+  // every entity needs a transform
+  const SnapshotTocEntry* transforms = view.sections[(size_t)SnapshotSection::TRANSFORM];
+  if (transforms == nullptr)
+    return false;
+  const uint32_t* ids = section_ptr<uint32_t>(view, transforms->ids_offset);
+  for (uint64_t i = 0; i < transforms->count; i++) {
+    const auto index = (size_t)entt::to_entity(entt::entity{ ids[i] });
+    if (index >= view.slots.size())
+      view.slots.resize(index + 1, UINT32_MAX);
+    if (view.slots[index] != UINT32_MAX)
+      return false; // saved twice
+    view.slots[index] = (uint32_t)i;
+  }
+
+  // and every other section must refer to one
+  for (const SnapshotTocEntry* entry : view.sections) {
+    if (entry == nullptr || entry->ids_offset == 0)
+      continue;
+    const uint32_t* entry_ids = section_ptr<uint32_t>(view, entry->ids_offset);
+    for (uint64_t i = 0; i < entry->count; i++) {
+      const auto index = (size_t)entt::to_entity(entt::entity{ entry_ids[i] });
+      if (index >= view.slots.size() || view.slots[index] == UINT32_MAX)
+        return false;
+    }
+  }
+
+  // and every inventory must be inside the pool
+  if (const SnapshotTocEntry* inventories = view.sections[(size_t)SnapshotSection::INVENTORY]) {
+    const SnapshotTocEntry* pool = view.sections[(size_t)SnapshotSection::INVENTORY_POOL];
+    const uint64_t n_slots = pool ? pool->count : 0;
+    const auto* invs = section_ptr<InventoryComponent>(view, inventories->data_offset);
+    for (uint64_t i = 0; i < inventories->count; i++) {
+      if ((uint64_t)invs[i].offset + invs[i].capacity > n_slots || invs[i].count > invs[i].capacity)
+        return false;
+    }
+  }
+
+  return true;
+};
+
+// saved ids -> entities in this registry
+static void
+remap_ids(const SnapshotView& view,
+          const SnapshotTocEntry& entry,
+          std::span<const entt::entity> created,
+          std::vector<entt::entity>& out)
+{
+  const uint32_t* ids = section_ptr<uint32_t>(view, entry.ids_offset);
+  out.resize(entry.count);
+  for (uint64_t i = 0; i < entry.count; i++)
+    out[i] = created[view.slots[(size_t)entt::to_entity(entt::entity{ ids[i] })]];
+};
+
+template<typename T>
+static void
+load_section(Registry& r,
+             const SnapshotView& view,
+             std::span<const entt::entity> created,
+             std::vector<entt::entity>& scratch)
+{
+  const SnapshotTocEntry* entry = view.sections[(size_t)snapshot_section<T>];
+  if (entry == nullptr || entry->count == 0)
+    return;
+
+  // the components are inserted straight from the mapped file
+  static_assert(alignof(T) <= SNAPSHOT_ALIGN);
+  remap_ids(view, *entry, created, scratch);
+  const T* data = section_ptr<T>(view, entry->data_offset);
+  r.insert<T>(scratch.begin(), scratch.end(), data);
+};
+
+static void
+load_inventory_pool(Registry& r, const SnapshotView& view)
+{
+  InventoryPool& pool = get_inventory_pool(r);
+  pool.slots.clear();
+  pool.free.clear();
+
+  const SnapshotTocEntry* entry = view.sections[(size_t)SnapshotSection::INVENTORY_POOL];
+  if (entry == nullptr)
+    return;
+  const ItemId* slots = section_ptr<ItemId>(view, entry->data_offset);
+  pool.slots.assign(slots, slots + entry->count);
+};
+
+static void
+load_bodies(Registry& r,
+            const b2WorldId world_id,
+            const SnapshotView& view,
+            std::span<const entt::entity> created,
+            std::vector<entt::entity>& scratch)
+{
+  const SnapshotTocEntry* entry = view.sections[(size_t)SnapshotSection::PHYSICS_BODY];
+  if (entry == nullptr || entry->count == 0)
+    return;
+  remap_ids(view, *entry, created, scratch);
+  const SnapshotBody* bodies = section_ptr<SnapshotBody>(view, entry->data_offset);
+
+  // bodies are created in a batch per kind of body
+  struct Batch
+  {
+    std::vector<entt::entity> entities;
+    std::vector<vec2> positions;
+    std::vector<vec2> sizes;
+    std::vector<b2Vec2> velocities;
+  };
+  Batch batches[2][2]; // [is_static][is_sensor]
+
+  for (uint64_t i = 0; i < entry->count; i++) {
+    const SnapshotBody& body = bodies[i];
+    const bool is_static = (body.flags & SNAPSHOT_BODY_STATIC) != 0;
+    const bool is_sensor = (body.flags & SNAPSHOT_BODY_SENSOR) != 0;
+    Batch& batch = batches[is_static][is_sensor];
+    batch.entities.push_back(scratch[i]);
+    batch.positions.push_back({ body.center_x, body.center_y });
+    batch.sizes.push_back({ body.size_x, body.size_y });
+    batch.velocities.push_back({ body.velocity_x, body.velocity_y });
+  }
+
+  for (int is_static = 0; is_static < 2; is_static++) {
+    for (int is_sensor = 0; is_sensor < 2; is_sensor++) {
+      const Batch& batch = batches[is_static][is_sensor];
+      attach_bodies_batch(
+        r, world_id, batch.entities, batch.positions, batch.sizes, batch.velocities, is_static == 1, is_sensor == 1);
+    }
+  }
+};
+
+bool
+load_world_snapshot(Registry& r, const b2WorldId world_id, const char* path)
+{
+  const Uint64 start = SDL_GetTicksNS();
+
+  MappedFile file;
+  if (!map_file(file, path))
+    return false;
+
+  SnapshotView view;
+  view.bytes = mapped_bytes(file);
+  if (!validate_snapshot(view)) {
+    SDL_Log("load_world_snapshot(): %s is not a valid snapshot for this build", path);
+    unmap_file(file);
+    return false;
+  }
+
+  // entities are created in the order they were saved
+  const SnapshotTocEntry& transforms = *view.sections[(size_t)SnapshotSection::TRANSFORM];
+  std::vector<entt::entity> created(transforms.count);
+  r.create(created.begin(), created.end());
+
+  // tags go in before the bodies, so the collision filters see them
+  std::vector<entt::entity> scratch;
+  load_section<TransformComponent>(r, view, created, scratch);
+  load_section<ColourComponent>(r, view, created, scratch);
+  load_inventory_pool(r, view);
+  load_section<InventoryComponent>(r, view, created, scratch);
+  load_section<PlayerComponent>(r, view, created, scratch);
+  load_section<ContainerProviderComponent>(r, view, created, scratch);
+  load_section<ContainerReceiverComponent>(r, view, created, scratch);
+  load_section<PointOfInterestComponent>(r, view, created, scratch);
+  load_section<NavObstacleComponent>(r, view, created, scratch);
+  load_section<FlowAgentComponent>(r, view, created, scratch);
+  load_bodies(r, world_id, view, created, scratch);
+  rebuild_inventory_free_ranges(r);
+
+  unmap_file(file);
+
+  const float ms = (float)(1e-6 * (double)(SDL_GetTicksNS() - start));
+  SDL_Log("loaded %zu entities from %s in %0.2fms", created.size(), path, ms);
+  return true;
+};
+
+} // namespace game2d
@@ -0,0 +1,91 @@
+#pragma once
+
+#include "core/registry.hpp"
+
+#include <box2d/box2d.h>
+#include <entt/fwd.hpp>
+
+#include <cstdint>
+
+//
+// Saves the registry and its box2d bodies to a binary file,
+// and loads it back by mapping the file and bulk inserting each pool.
+//
+// layout (little endian, every section starts 16 byte aligned):
+//   header:   magic, version, n_sections, reserved, file_size
+//   toc:      n_sections * { section, elem_size, count, ids_offset, data_offset }
+//   sections: entity ids (u32[count]), then elements (elem_size * count)
+//
+// sections that are not per entity (the inventory pool) have no ids, and an ids_offset of 0.
+//
+// components are written as they are laid out in memory, so
+// changing a saved component means bumping SNAPSHOT_VERSION.
+//
+
+namespace game2d {
+
+constexpr uint32_t SNAPSHOT_MAGIC = 0x50534E53; // "SNSP"
+constexpr uint32_t SNAPSHOT_VERSION = 3;
+
+enum class SnapshotSection : uint32_t
+{
+  TRANSFORM,
+  COLOUR,
+  INVENTORY,
+  PLAYER,
+  CONTAINER_PROVIDER,
+  CONTAINER_RECEIVER,
+  POINT_OF_INTEREST,
+  NAV_OBSTACLE,
+  FLOW_AGENT,
+  PHYSICS_BODY,
+  INVENTORY_POOL,
+  COUNT,
+};
+
+struct SnapshotHeader
+{
+  uint32_t magic = SNAPSHOT_MAGIC;
+  uint32_t version = SNAPSHOT_VERSION;
+  uint32_t n_sections = 0;
+  uint32_t reserved = 0;
+  uint64_t file_size = 0;
+};
+static_assert(sizeof(SnapshotHeader) == 24);
+
+struct SnapshotTocEntry
+{
+  SnapshotSection section = SnapshotSection::COUNT;
+  uint32_t elem_size = 0;
+  uint64_t count = 0;
+  uint64_t ids_offset = 0;
+  uint64_t data_offset = 0;
+};
+static_assert(sizeof(SnapshotTocEntry) == 32);
+
+// a body is saved as the box it was spawned as
+struct SnapshotBody
+{
+  uint32_t flags = 0; // SNAPSHOT_BODY_*
+  float size_x = 0.0f; // pixels
+  float size_y = 0.0f;
+  float center_x = 0.0f; // pixels
+  float center_y = 0.0f;
+  float velocity_x = 0.0f; // meters per second
+  float velocity_y = 0.0f;
+};
+static_assert(sizeof(SnapshotBody) == 28);
+
+constexpr uint32_t SNAPSHOT_BODY_STATIC = 1 << 0;
+constexpr uint32_t SNAPSHOT_BODY_SENSOR = 1 << 1;
+
+// the world must not be stepping
+bool
+save_world_snapshot(const Registry& r, const char* path);
+
+// expects an empty registry and a new world.
+// returns false (and logs) if the file is missing or does not match this build.
+bool
+load_world_snapshot(Registry& r, const b2WorldId world_id, const char* path);
+
+} // namespace game2d
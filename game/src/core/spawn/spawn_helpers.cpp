@@ -0,0 +1,177 @@
+#include "core/pch.hpp"
+
+#include "core/spawn/spawn_helpers.hpp"
+
+#include "core/box2d/box2d_components.hpp"
+#include "core/box2d/box2d_helpers.hpp"
+
+namespace game2d {
+
+const SpawnDefs&
+get_spawn_defs(const bool is_static, const bool is_sensor)
+{
+  const auto make_defs = [](const bool is_static, const bool is_sensor) -> SpawnDefs {
+    SpawnDefs defs;
+    defs.body_def = b2DefaultBodyDef();
+    defs.body_def.type = is_static ? b2_staticBody : b2_dynamicBody;
+    defs.body_def.fixedRotation = true;
+    defs.body_def.linearDamping = 5.0f;
+
+    defs.shape_def = b2DefaultShapeDef();
+    defs.shape_def.isSensor = is_sensor;
+    defs.shape_def.enableContactEvents = true;
+    defs.shape_def.enableSensorEvents = true;
+    return defs;
+  };
+
+  // [is_static][is_sensor]
+  static const SpawnDefs defs[2][2] = {
+    { make_defs(false, false), make_defs(false, true) },
+    { make_defs(true, false), make_defs(true, true) },
+  };
+  return defs[is_static][is_sensor];
+};
+
+entt::entity
+spawn(Registry& r,
+      const b2WorldId world_id,
+      const vec2 pos,
+      const vec2 size,
+      const ColourComponent colour,
+      const bool is_static,
+      const bool is_sensor)
+{
+  const SpawnDefs& defs = get_spawn_defs(is_static, is_sensor);
+  const entt::entity e = r.create();
+  const entt::entity shape_e = r.create();
+
+  const b2Vec2 size_meters = pixels_to_meters(size);
+  const b2Polygon box = b2MakeBox(0.5f * size_meters.x, 0.5f * size_meters.y);
+
+  b2BodyDef body_def = defs.body_def;
+  body_def.position = pixels_to_meters(pos);
+  body_def.userData = entity_to_user_data(e);
+  const b2BodyId body_id = b2CreateBody(world_id, &body_def);
+
+  b2ShapeDef shape_def = defs.shape_def;
+  shape_def.userData = entity_to_user_data(shape_e);
+  const b2ShapeId shape_id = b2CreatePolygonShape(body_id, &shape_def, &box);
+
+  TransformComponent t_c;
+  t_c.size = meters_to_pixels(size_meters);
+  t_c.pos = meters_to_pixels(body_def.position) - (0.5f * t_c.size);
+
+  r.emplace<TransformComponent>(e, t_c);
+  r.emplace<ColourComponent>(e, ColourComponent{ .r = colour.r, .g = colour.g, .b = colour.b });
+  r.emplace<PhysicsBodyComponent>(e, make_physics_body_component(body_id));
+  r.emplace<PhysicsShapeComponent>(shape_e, PhysicsShapeComponent{ .body_id = body_id, .shape_id = shape_id });
+
+  return e;
+};
+
+void
+spawn_batch(Registry& r,
+            const b2WorldId world_id,
+            std::span<const vec2> positions,
+            std::span<const vec2> sizes,
+            std::span<const ColourComponent> colours,
+            std::span<entt::entity> out,
+            const bool is_static,
+            const bool is_sensor,
+            std::pmr::memory_resource* scratch)
+{
+  const size_t n = out.size();
+  assert(positions.size() == n);
+  assert(sizes.size() == n);
+  assert(colours.size() == n);
+  if (n == 0)
+    return;
+
+  std::pmr::vector<TransformComponent> transforms(n, scratch);
+  std::pmr::vector<ColourComponent> cols(n, scratch);
+
+  // reserve storage up front, so inserting doesnt reallocate per entity
+  auto& transform_storage = r.storage<TransformComponent>();
+  auto& colour_storage = r.storage<ColourComponent>();
+  transform_storage.reserve(transform_storage.size() + n);
+  colour_storage.reserve(colour_storage.size() + n);
+
+  r.create(out.begin(), out.end());
+
+  for (size_t i = 0; i < n; i++) {
+    const b2Vec2 half_size_meters = pixels_to_meters(0.5f * sizes[i]);
+
+    TransformComponent& t_c = transforms[i];
+    t_c.size = meters_to_pixels(b2Vec2{ 2.0f * half_size_meters.x, 2.0f * half_size_meters.y });
+    t_c.pos = meters_to_pixels(pixels_to_meters(positions[i])) - (0.5f * t_c.size);
+    t_c.rotation_radians = 0.0f;
+
+    cols[i] = ColourComponent{ .r = colours[i].r, .g = colours[i].g, .b = colours[i].b };
+  }
+
+  r.insert<TransformComponent>(out.begin(), out.end(), transforms.begin());
+  r.insert<ColourComponent>(out.begin(), out.end(), cols.begin());
+  attach_bodies_batch(r, world_id, out, positions, sizes, {}, is_static, is_sensor, scratch);
+};
+
+void
+attach_bodies_batch(Registry& r,
+                    const b2WorldId world_id,
+                    std::span<const entt::entity> entities,
+                    std::span<const vec2> positions,
+                    std::span<const vec2> sizes,
+                    std::span<const b2Vec2> velocities,
+                    const bool is_static,
+                    const bool is_sensor,
+                    std::pmr::memory_resource* scratch)
+{
+  const size_t n = entities.size();
+  assert(positions.size() == n);
+  assert(sizes.size() == n);
+  assert(velocities.empty() || velocities.size() == n);
+  if (n == 0)
+    return;
+
+  std::pmr::vector<entt::entity> shape_es(n, scratch);
+  std::pmr::vector<PhysicsBodyComponent> bodies(n, scratch);
+  std::pmr::vector<PhysicsShapeComponent> shapes(n, scratch);
+
+  auto& body_storage = r.storage<PhysicsBodyComponent>();
+  auto& shape_storage = r.storage<PhysicsShapeComponent>();
+  body_storage.reserve(body_storage.size() + n);
+  shape_storage.reserve(shape_storage.size() + n);
+
+  r.create(shape_es.begin(), shape_es.end());
+
+  const SpawnDefs& defs = get_spawn_defs(is_static, is_sensor);
+  b2BodyDef body_def = defs.body_def;
+  b2ShapeDef shape_def = defs.shape_def;
+
+  for (size_t i = 0; i < n; i++) {
+    const b2Vec2 half_size_meters = pixels_to_meters(0.5f * sizes[i]);
+    const b2Polygon box = b2MakeBox(half_size_meters.x, half_size_meters.y);
+
+    body_def.position = pixels_to_meters(positions[i]);
+    body_def.linearVelocity = velocities.empty() ? b2Vec2_zero : velocities[i];
+    body_def.userData = entity_to_user_data(entities[i]);
+    const b2BodyId body_id = b2CreateBody(world_id, &body_def);
+
+    shape_def.userData = entity_to_user_data(shape_es[i]);
+    const b2ShapeId shape_id = b2CreatePolygonShape(body_id, &shape_def, &box);
+
+    // the box is centered on the body, so the extents are known
+    PhysicsBodyComponent& pb_c = bodies[i];
+    pb_c.id = body_id;
+    pb_c.shape_ids[0] = shape_id;
+    pb_c.n_shapes = 1;
+    pb_c.local_aabb.lowerBound = { -half_size_meters.x, -half_size_meters.y };
+    pb_c.local_aabb.upperBound = half_size_meters;
+
+    shapes[i] = PhysicsShapeComponent{ .body_id = body_id, .shape_id = shape_id };
+  }
+
+  r.insert<PhysicsBodyComponent>(entities.begin(), entities.end(), bodies.begin());
+  r.insert<PhysicsShapeComponent>(shape_es.begin(), shape_es.end(), shapes.begin());
+};
+
+} // namespace game2d
@@ -0,0 +1,63 @@
+#pragma once
+
+#include "core/common.hpp"
+
+#include <box2d/box2d.h>
+#include <entt/fwd.hpp>
+
+#include <memory_resource>
+#include <span>
+
+namespace game2d {
+
+// b2BodyDef/b2ShapeDef are prepared once per kind of body,
+// and copied for each spawn.
+struct SpawnDefs
+{
+  b2BodyDef body_def;
+  b2ShapeDef shape_def;
+};
+
+const SpawnDefs&
+get_spawn_defs(const bool is_static, const bool is_sensor);
+
+// one box body with one shape.
+// creates a parent entity (returned) and an entity for the shape.
+entt::entity
+spawn(Registry& r,
+      const b2WorldId world_id,
+      const vec2 pos,
+      const vec2 size,
+      const ColourComponent colour,
+      const bool is_static = false,
+      const bool is_sensor = false);
+
+// same as spawn(), for many bodies at once.
+// positions, sizes and colours must be the same length as out.
+// scratch is for the temporary arrays, e.g. frame_resource() on the gamethread.
+void
+spawn_batch(Registry& r,
+            const b2WorldId world_id,
+            std::span<const vec2> positions,
+            std::span<const vec2> sizes,
+            std::span<const ColourComponent> colours,
+            std::span<entt::entity> out,
+            const bool is_static = false,
+            const bool is_sensor = false,
+            std::pmr::memory_resource* scratch = std::pmr::get_default_resource());
+
+// creates a box body (and shape entity) for each of the existing entities.
+// positions are body centres, in pixels. velocities (meters per second) can be empty.
+// anything that changes the collision filter should be emplaced first.
+void
+attach_bodies_batch(Registry& r,
+                    const b2WorldId world_id,
+                    std::span<const entt::entity> entities,
+                    std::span<const vec2> positions,
+                    std::span<const vec2> sizes,
+                    std::span<const b2Vec2> velocities,
+                    const bool is_static = false,
+                    const bool is_sensor = false,
+                    std::pmr::memory_resource* scratch = std::pmr::get_default_resource());
+
+} // namespace game2d
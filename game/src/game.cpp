@@ -3,21 +3,74 @@
 #include "game.hpp"
 
 #include "actors/actor_player/actor_player_components.hpp"
+#include "core/box2d/box2d_categories.hpp"
+#include "core/box2d/box2d_collisions.hpp"
 #include "core/box2d/box2d_components.hpp"
 #include "core/box2d/box2d_helpers.hpp"
+#include "core/box2d/box2d_query.hpp"
 #include "core/camera/camera_helpers.hpp"
 #include "core/common.hpp"
 #include "core/entt/entt_helpers.hpp"
+#include "core/input/input.hpp"
+#include "core/inventory/inventory_pool.hpp"
 #include "core/maths/helpers.hpp"
+#include "core/particles/particles.hpp"
+#include "core/render/renderables.hpp"
+#include "core/scheduler/scheduler.hpp"
+#include "core/snapshot/world_snapshot.hpp"
+#include "core/physics/physics_pipeline.hpp"
+#include "core/prefabs/prefabs.hpp"
 #include "render_helpers.hpp"
 #include "systems/system_events/events_components.hpp"
+#include "systems/system_collisions/collisions_system.hpp"
+#include "systems/system_destroy/destroy_system.hpp"
+#include "systems/system_flow_field/flow_field_system.hpp"
 #include "systems/system_items/items_components.hpp"
+#include "systems/system_particles/particles_components.hpp"
+#include "systems/system_particles/particles_system.hpp"
+#include "systems/system_physics_activity/physics_activity_system.hpp"
+#include "systems/system_ui_model/ui_model_system.hpp"
 #include "systems/ui_system_gameover/ui_gameover_components.hpp"
 #include "systems/ui_system_gameover/ui_gameover_system.hpp"
 
 namespace game2d {
 
-static entt::registry internal_r;
+static Registry internal_r;
+static ParticleBuffer internal_particles;
+static RandomState particles_rnd;
+static DestroyQueue destroy_queue;
+static CollisionEvents collision_events;
+static PhysicsActivity physics_activity;
+static SystemSchedule update_schedule;
+static UiModelBuilder ui_model;
+static PrefabLibrary prefabs;
+static const Prefab* agent_prefab = nullptr; // spawned every tick, so resolved once
+static const Prefab* crate_prefab = nullptr;
+static FlowFieldState flow_field;
+static InputState input;
+
+// queued by the collision handlers, applied together after dispatch
+static std::vector<InventoryTransfer> inventory_transfers;
+
+// tags for state outside the registry, used to declare system access
+struct Res_Input
+{};
+struct Res_Camera
+{};
+struct Res_Particles
+{};
+struct Res_UiData
+{};
+struct Res_FlowField
+{};
+static std::vector<entt::entity> pick_results;
+
+// box2d calls are deferred to apply_world_mutations(),
+// as the world could be stepping on the physics thread during game_update().
+// pick and spawn requests go through the engine's event bus.
+static bool save_requested = false;
+static bool load_requested = false;
+static bool agents_requested = false;
 static bool refreshed = false;
 const auto screen_size = vec2(1280, 720); // todo: fix this
 
@@ -35,145 +88,118 @@ const auto jump_force = b2Vec2{ 0.0f, -5.0f };
 const auto move_force = 0.5f;
 static b2Vec2 gravity = { 0.0f, 0.0f };
 
-const auto get_system_time_for_seed = []() -> int {
-  auto now = std::chrono::high_resolution_clock::now();
-  long long seed = std::chrono::duration_cast<std::chrono::nanoseconds>(now.time_since_epoch()).count();
-  return seed;
+const auto hit_sparks = ParticleDesc{
+  .velocity_min = { -250, -250 },
+  .velocity_max = { 250, 250 },
+  .lifetime_min = 0.2f,
+  .lifetime_max = 0.6f,
+  .size = 4.0f,
+  .colour = { 1.0f, 0.8f, 0.2f, 1.0f },
 };
 
-entt::entity
-spawn(GameData* data,
-      const vec2 pos,
-      const vec2 size,
-      const ColourComponent colour,
-      const bool is_static = false,
-      const bool is_sensor = false)
+void
+emit_hit_sparks(Registry& r, const entt::entity e)
 {
-  auto& r = internal_r;
-
-  b2Vec2 size_meters = pixels_to_meters(size);
-  b2Polygon box = b2MakeBox(0.5f * size_meters.x, 0.5f * size_meters.y);
-
-  b2BodyDef bodyDef = b2DefaultBodyDef();
-  bodyDef.type = is_static ? b2_staticBody : b2_dynamicBody;
-  bodyDef.position = b2Vec2{ pixels_to_meters(pos) };
-  bodyDef.fixedRotation = true;
-  b2BodyId body_id = b2CreateBody(data->world_id, &bodyDef);
-
-  b2Body_SetLinearDamping(body_id, 5.0f);
-
-  b2ShapeDef shapeDef = b2DefaultShapeDef();
-  shapeDef.isSensor = is_sensor;
-  shapeDef.enableContactEvents = true;
-  shapeDef.enableSensorEvents = true;
-  b2ShapeId shape_id = b2CreatePolygonShape(body_id, &shapeDef, &box);
-
-  TransformComponent t_c;
-  t_c.pos = meters_to_pixels({ bodyDef.position.x, bodyDef.position.y });
-  t_c.size = meters_to_pixels(size_meters);
-
-  // float rnd_r = random(rnd, 0.0f, 1.0f);
-  // float rnd_g = random(rnd, 0.0f, 1.0f);
-  // float rnd_b = random(rnd, 0.0f, 1.0f);
-
-  entt::entity e = r.create();
-  r.emplace<TransformComponent>(e, t_c);
-  r.emplace<ColourComponent>(e, ColourComponent{ .r = colour.r, .g = colour.g, .b = colour.b });
-  r.emplace<PhysicsBodyComponent>(e, PhysicsBodyComponent{ .id = body_id, .shape_ids = { shape_id } });
-  set_entity_from_body_id(body_id, e);
-
-  entt::entity shape_e = r.create();
-  r.emplace<PhysicsShapeComponent>(shape_e, PhysicsShapeComponent{ .body_id = body_id, .shape_id = shape_id });
-  set_entity_from_shape_id(shape_id, shape_e);
-
-  return e;
-};
+  const auto& t_c = r.get<const TransformComponent>(e);
+  emit_particles(internal_particles, particles_rnd, t_c.pos + 0.5f * t_c.size, hit_sparks, 64);
+}
 
 void
-handle_on_coll_enter__check_for_gameover(entt::registry& r, const OnCollisionEnter& evt)
+on_enter_player_provider(Registry& r, const CollisionPair& pair)
 {
-  const auto parent_a_e = get_entity_from_body_id(r.get<const PhysicsShapeComponent>(evt.shape_a).body_id);
-  const auto parent_b_e = get_entity_from_body_id(r.get<const PhysicsShapeComponent>(evt.shape_b).body_id);
-  const auto [shape_a, shape_b] = coll<const PlayerComponent, const ContainerReceiverComponent>(r, parent_a_e, parent_b_e);
-
-  if (shape_a == entt::null || shape_b == entt::null)
-    return; // not a coll of interest
-
-  const auto& consumer_inv = r.get<const InventoryComponent>(parent_b_e);
-  SDL_Log("consumer has: %i items", consumer_inv.items);
-
-  const bool gameover = consumer_inv.items >= 5;
-  if (gameover) {
-    SDL_Log("dingding! gameover");
-    create_empty<Request_GameOver>(r);
-  }
+  LOG(DEBUG, GAMEPLAY, "collision enter with provider.");
+  inventory_transfers.push_back({ .from = pair.parent_b, .to = pair.parent_a, .n = 1 });
 }
 
 void
-handle_on_coll_enter__log(entt::registry& r, const OnCollisionEnter& evt)
+on_enter_player_receiver(Registry& r, const CollisionPair& pair)
 {
-  const auto parent_a_e = get_entity_from_body_id(r.get<const PhysicsShapeComponent>(evt.shape_a).body_id);
-  const auto parent_b_e = get_entity_from_body_id(r.get<const PhysicsShapeComponent>(evt.shape_b).body_id);
-
-  SDL_Log("collision enter. s_eid: %i par_eid: %i, s_eid: %i, par_eid: %i ",
-          (uint32_t)evt.shape_a,
-          parent_a_e,
-          (uint32_t)evt.shape_b,
-          parent_b_e);
-
-  {
-    const auto [shape_a, shape_b] = coll<const PlayerComponent, const ContainerProviderComponent>(r, parent_a_e, parent_b_e);
-    if (shape_a != entt::null && shape_b != entt::null) {
-      SDL_Log("collision enter with provider.");
-
-      auto& provider_inv = r.get<InventoryComponent>(parent_b_e);
-      if (provider_inv.items <= 0)
-        return; // no more items to give
-      provider_inv.items--;
+  LOG(DEBUG, GAMEPLAY, "collision enter with reciever.");
+  inventory_transfers.push_back({ .from = pair.parent_a, .to = pair.parent_b, .n = 1 });
+}
 
-      auto& player_inv = r.get<InventoryComponent>(parent_a_e);
-      player_inv.items++;
+void
+handle_inventory_transfers(Registry& r)
+{
+  apply_inventory_transfers(r, inventory_transfers);
+
+  for (const InventoryTransfer& t : inventory_transfers) {
+    if (t.moved > 0)
+      emit_hit_sparks(r, t.to);
+
+    // check for gameover
+    if (!r.valid(t.to) || !r.all_of<ContainerReceiverComponent>(t.to))
+      continue;
+    const auto& consumer_inv = r.get<const InventoryComponent>(t.to);
+    LOG(INFO, GAMEPLAY, "consumer has: %i items", consumer_inv.count);
+    const bool gameover = consumer_inv.count >= 5;
+    if (gameover) {
+      LOG(INFO, GAMEPLAY, "dingding! gameover");
+      create_empty<Request_GameOver>(r);
     }
   }
+  inventory_transfers.clear();
+}
 
-  {
-    const auto [shape_a, shape_b] = coll<const PlayerComponent, const ContainerReceiverComponent>(r, parent_a_e, parent_b_e);
-    if (shape_a != entt::null && shape_b != entt::null) {
-      SDL_Log("collision enter with reciever.");
-
-      auto& player_inv = r.get<InventoryComponent>(parent_a_e);
-      if (player_inv.items <= 0)
-        return; // no item on player
-      player_inv.items--;
-
-      auto& consumer_inv = r.get<InventoryComponent>(parent_b_e);
-      consumer_inv.items++;
+// built at compile time. categories without a handler get no events.
+constexpr CollisionHandlerTable
+make_on_enter_handlers()
+{
+  CollisionHandlerTable table{};
+  add_collision_handler(table, CollisionCategory::PLAYER, CollisionCategory::CONTAINER_PROVIDER, &on_enter_player_provider);
+  add_collision_handler(table, CollisionCategory::PLAYER, CollisionCategory::CONTAINER_RECEIVER, &on_enter_player_receiver);
+  return table;
+};
+constexpr CollisionHandlerTable on_enter_handlers = make_on_enter_handlers();
+constexpr CollisionMasks on_enter_masks = make_collision_masks(on_enter_handlers);
 
-      // check for gameover
-      handle_on_coll_enter__check_for_gameover(r, evt);
-    }
+void
+handle_on_coll_enter__log(Registry& r, std::span<const CollisionPair> pairs)
+{
+  for (const CollisionPair& pair : pairs) {
+    LOG(DEBUG,
+        COLLISION,
+        "collision enter. s_eid: %i par_eid: %i, s_eid: %i, par_eid: %i ",
+        (uint32_t)pair.shape_a,
+        (uint32_t)pair.parent_a,
+        (uint32_t)pair.shape_b,
+        (uint32_t)pair.parent_b);
   }
 }
 
 void
-handle_on_coll_exit__log(entt::registry& r, const OnCollisionExit& coll_evt)
+handle_on_coll_exit__log(Registry& r, std::span<const CollisionPair> pairs)
 {
-  SDL_Log("collision exit.");
+  for (const CollisionPair& pair : pairs)
+    LOG(DEBUG, COLLISION, "collision exit.");
 }
 
-void
-game_init(GameData* data)
+// an empty registry and world, ready to be filled
+static void
+init_world(GameData* data)
 {
-  SDL_Log("(GameEngine) Init()");
+  // compiled once, spawned from many times
+  if (prefabs.prefabs.empty()) {
+    const char* base_path = SDL_GetBasePath();
+    load_prefabs(prefabs, (std::string(base_path ? base_path : "") + "assets/config/prefabs.json").c_str());
+    agent_prefab = &get_prefab(prefabs, "agent");
+    crate_prefab = &get_prefab(prefabs, "crate");
+  }
+
+  // the bus outlives the dll, registering again keeps pending events
+  register_game_events(*data->bus);
+
+  // the registry allocator looks up the tracker per module, so the dll sets its own
+  set_registry_memory(data->memory);
+  set_logger(data->logger);
 
-  // sets as an instance of an entt::registry used by this dll
+  // sets as an instance of a Registry used by this dll
   data->r = &internal_r;
+  data->particles = &internal_particles;
   auto& r = internal_r;
 
-  {
-    const auto& view = r.view<TransformComponent, ColourComponent>();
-    SDL_Log("renderables: %zu", view.size_hint());
-  }
+  // create the owning group before anything is spawned
+  get_renderables_group(r);
 
   b2WorldDef world_def = b2DefaultWorldDef();
   // world_def.workerCount = worker_count;
@@ -184,40 +210,94 @@ game_init(GameData* data)
   world_def.enableSleep = true;
   data->world_id = b2CreateWorld(&world_def);
 
-  // spawn(data, { 1280 * 0.5f, 720 * 0.75f }, { 1000, 50 }, true); // static
+  // filters are set as bodies and tags are added
+  init_collision_filters(r, on_enter_masks);
+
+  // items live in one pool, in the registry's context
+  init_inventory_pool(r);
+
+  // tracks inventories as they are added and changed
+  init_ui_model(r, ui_model);
+
+  // agents seek the receiver. walls are found from the obstacles.
+  init_flow_field_system(r, flow_field, (int)screen_size.x / 20, (int)screen_size.y / 20, 20);
+};
+
+static std::string
+get_quicksave_path()
+{
+  const char* base_path = SDL_GetBasePath();
+  return std::string(base_path ? base_path : "") + "quicksave.snapshot";
+};
+
+void
+game_init(GameData* data)
+{
+  SDL_Log("(GameEngine) Init()");
+  init_world(data);
+  auto& r = internal_r;
+
+  // spawn(r, data->world_id, { 1280 * 0.5f, 720 * 0.75f }, { 1000, 50 }, true); // static
 
   // rnd_x on left side of screen.
-  int seed = 0;
-#if defined(_DEBUG)
-  seed = get_system_time_for_seed();
-#endif
-  static RandomState rnd(seed);
+  static RandomState rnd(data->seed);
   const auto rnd_0_x = random(rnd, 100.0f, 450.0f);
   const auto rnd_1_x = random(rnd, 550.0f, 900.0f);
 
-  const auto provider_e = spawn(data, { rnd_0_x, 300 }, { 50, 50 }, { 1.0f, 0.0f, 0.0f });
-  r.emplace<ContainerProviderComponent>(provider_e);
-  r.emplace<InventoryComponent>(provider_e, InventoryComponent{ .items = 5 });
-
-  const auto consumer_e = spawn(data, { rnd_1_x, 450 }, { 50, 50 }, { 0.0f, 1.0f, 0.0f });
-  r.emplace<ContainerReceiverComponent>(consumer_e);
-  r.emplace<InventoryComponent>(consumer_e, InventoryComponent{ .items = 0 });
-
-  const auto player_e = spawn(data, { 500, 450 }, { 50, 50 }, { 0.0f, 0.0f, 1.0f }, false, true);
-  r.emplace<PlayerComponent>(player_e);
-  r.emplace<InventoryComponent>(player_e, InventoryComponent{ .items = 0 });
+  spawn_prefab(r, data->world_id, get_prefab(prefabs, "container_provider"), { rnd_0_x, 300 });
+  spawn_prefab(r, data->world_id, get_prefab(prefabs, "container_receiver"), { rnd_1_x, 450 });
+  spawn_prefab(r, data->world_id, get_prefab(prefabs, "player"), { 500, 450 });
+  spawn_prefab(r, data->world_id, get_prefab(prefabs, "wall"), { 500, 200 });
 
-  // setup events
-  auto& evts_c = SINGLE_Events::get();
-  evts_c.dispatcher.sink<OnCollisionEnter>().connect<&handle_on_coll_enter__log>(r);
-  evts_c.dispatcher.sink<OnCollisionExit>().connect<&handle_on_coll_exit__log>(r);
-  evts_c.dispatcher.sink<OnCollisionEnter>().connect<&handle_on_coll_enter__check_for_gameover>(r);
+  // static bodies never generate move events
+  update_transforms_from_physics(r);
 };
 
+// everything that changes the b2World happens here, between steps
 void
-game_fixed_update(GameData* data)
+apply_world_mutations(Registry& r, GameData* data)
 {
-  auto& r = internal_r;
+  if (save_requested) {
+    save_requested = false;
+    save_world_snapshot(r, get_quicksave_path().c_str());
+  }
+  if (load_requested) {
+    load_requested = false;
+    const std::string path = get_quicksave_path();
+    if (!SDL_GetPathInfo(path.c_str(), nullptr))
+      SDL_Log("no quicksave at %s", path.c_str());
+    else {
+      game_refresh(data);
+      init_world(data);
+      if (!load_world_snapshot(r, data->world_id, path.c_str())) {
+        // dont leave an empty world
+        game_refresh(data);
+        game_init(data);
+      }
+    }
+  }
+
+  // a wave of agents on the left, seeking the receiver
+  if (agents_requested) {
+    agents_requested = false;
+    constexpr size_t n_agents = 1000;
+    static RandomState rnd(data->seed);
+    auto* positions = arena_alloc_array<vec2>(*data->frame_arena, n_agents);
+    auto* spawned = arena_alloc_array<entt::entity>(*data->frame_arena, n_agents);
+    if (positions != nullptr && spawned != nullptr) {
+      for (size_t i = 0; i < n_agents; i++)
+        positions[i] = { random(rnd, 20.0f, 400.0f), random(rnd, 20.0f, 700.0f) };
+      spawn_prefab_batch(r,
+                         data->world_id,
+                         *agent_prefab,
+                         { positions, n_agents },
+                         { spawned, n_agents },
+                         frame_resource(*data->frame_arena));
+    }
+  }
+
+  // steer the agents with the velocities sampled last update
+  apply_flow_agent_velocities(r);
 
   // Apply force to first dynamic body
   {
@@ -255,266 +335,132 @@ game_fixed_update(GameData* data)
     }
   }
 
-  // update world
-  {
-    constexpr int physics_substep_count = 4;
-    constexpr float physics_dt = 1.0f / 60.0f;
-    b2World_Step(data->world_id, physics_dt, physics_substep_count);
-  }
+  EventBus& bus = *data->bus;
 
-  // Generate contact events.
-  {
+  // test if you clicked a shape
+  consume<PickRequestEvent>(bus, [&](std::span<const PickRequestEvent> evts) {
+    for (const PickRequestEvent& evt : evts) {
+      query_point(data->world_id, evt.pos, pick_results);
+      for (const entt::entity e : pick_results)
+        enqueue_destroy(destroy_queue, e);
+    }
+  });
+
+  // safe point: nothing is iterating the registry
+  flush_destroy_queue(r, destroy_queue);
+
+  // scratch from the gamethread's frame arena
+  consume<SpawnRequestEvent>(bus, [&](std::span<const SpawnRequestEvent> evts) {
+    auto* positions = arena_alloc_array<vec2>(*data->frame_arena, evts.size());
+    auto* spawned = arena_alloc_array<entt::entity>(*data->frame_arena, evts.size());
+    if (positions == nullptr || spawned == nullptr) {
+      SDL_Log("(GameThread) frame arena full, %zu spawns dropped", evts.size());
+      return;
+    }
+    for (size_t i = 0; i < evts.size(); i++)
+      positions[i] = evts[i].pos;
+    spawn_prefab_batch(r,
+                       data->world_id,
+                       *crate_prefab,
+                       { positions, evts.size() },
+                       { spawned, evts.size() },
+                       frame_resource(*data->frame_arena));
+  });
+
+  // only simulate bodies near the camera and points of interest
+  update_physics_activity_system(r, physics_activity, camera_pos + 0.5f * screen_size);
+  data->ui_data.n_active_bodies = physics_activity.n_active;
+  data->ui_data.n_inactive_bodies = physics_activity.n_inactive;
+}
 
-    const auto convert_box2d_coll_to_entt = [](entt::registry& r, const b2ShapeId a, const b2ShapeId b, auto callback) {
-      const auto shape_eid_a = (entt::entity)(reinterpret_cast<uintptr_t>(b2Shape_GetUserData(a)));
-      const auto shape_eid_b = (entt::entity)(reinterpret_cast<uintptr_t>(b2Shape_GetUserData(b)));
+// copies what the last step produced out of the b2World
+void
+read_physics_results(Registry& r, GameData* data)
+{
+  // Update transforms of the bodies that moved.
+  update_transforms_from_body_events(r, data->world_id);
 
-      assert(shape_eid_a != entt::null);
-      assert(shape_eid_a != entt::null);
-      callback(shape_eid_a, shape_eid_b);
-    };
+  gather_collision_events(data->world_id, collision_events);
+  data->ui_data.n_sensor_events = collision_events.n_sensor_events;
+  data->ui_data.n_contact_events = collision_events.n_contact_events;
+}
 
-    const b2ContactEvents c_events = b2World_GetContactEvents(data->world_id);
-    const b2SensorEvents s_events = b2World_GetSensorEvents(data->world_id);
-    auto& ui_data = data->ui_data;
-    ui_data.n_sensor_events = s_events.beginCount + s_events.endCount;
-    ui_data.n_contact_events = c_events.beginCount + c_events.endCount;
-
-    for (int i = 0; i < c_events.beginCount; ++i) {
-      b2ContactBeginTouchEvent* beginEvent = c_events.beginEvents + i;
-      convert_box2d_coll_to_entt(
-        r, beginEvent->shapeIdA, beginEvent->shapeIdB, [&r](const entt::entity e_a, const entt::entity e_b) {
-          SINGLE_Events::get().dispatcher.trigger(OnCollisionEnter{ .shape_a = e_a, .shape_b = e_b });
-        });
-    }
-    for (int i = 0; i < c_events.endCount; ++i) {
-      b2ContactEndTouchEvent* endEvent = c_events.endEvents + i;
-      if (b2Shape_IsValid(endEvent->shapeIdA) && b2Shape_IsValid(endEvent->shapeIdB)) {
-        convert_box2d_coll_to_entt(
-          r, endEvent->shapeIdA, endEvent->shapeIdB, [](const entt::entity e_a, const entt::entity e_b) {
-            SINGLE_Events::get().dispatcher.trigger(OnCollisionExit{ .shape_a = e_a, .shape_b = e_b });
-          });
-      }
-    }
-    for (int i = 0; i < s_events.beginCount; ++i) {
-      b2SensorBeginTouchEvent* beginEvent = s_events.beginEvents + i;
-      convert_box2d_coll_to_entt(
-        r, beginEvent->sensorShapeId, beginEvent->visitorShapeId, [&r](const entt::entity e_a, const entt::entity e_b) {
-          SINGLE_Events::get().dispatcher.trigger(OnCollisionEnter{ .shape_a = e_a, .shape_b = e_b });
-        });
-    }
-    for (int i = 0; i < s_events.endCount; ++i) {
-      b2SensorEndTouchEvent* endEvent = s_events.endEvents + i;
-      if (b2Shape_IsValid(endEvent->sensorShapeId) && b2Shape_IsValid(endEvent->visitorShapeId)) {
-        convert_box2d_coll_to_entt(r, endEvent->sensorShapeId, endEvent->visitorShapeId, [](const auto e_a, const auto e_b) {
-          SINGLE_Events::get().dispatcher.trigger(OnCollisionExit{ .shape_a = e_a, .shape_b = e_b });
-        });
-      }
-    }
-    SINGLE_Events::get().dispatcher.update();
+void
+game_fixed_update(GameData* data)
+{
+  auto& r = internal_r;
+  auto& physics = *data->physics;
+  constexpr int physics_substep_count = 4;
+  const float physics_dt = data->fixed_dt;
+
+  if (physics.pipelined) {
+    // step N was kicked last tick. read its results, then kick step N+1
+    // so it runs while the results are processed below.
+    // gameplay sees physics one tick late.
+    if (wait_physics_step(physics))
+      read_physics_results(r, data);
+    apply_world_mutations(r, data);
+    kick_physics_step(physics, data->world_id, physics_dt, physics_substep_count);
+  } else {
+    apply_world_mutations(r, data);
+    b2World_Step(data->world_id, physics_dt, physics_substep_count);
+    read_physics_results(r, data);
+  }
+
+  // handlers consume the whole span of events.
+  // the world could be stepping, so handlers must not call in to box2d.
+  {
+    handle_on_coll_enter__log(r, collision_events.enter);
+    handle_on_coll_exit__log(r, collision_events.exit);
+    dispatch_collisions(r, on_enter_handlers, collision_events.enter);
+    handle_inventory_transfers(r);
   }
 };
 
 void
-game_update(GameData* data)
+update_input_system(SystemContext& ctx)
 {
-  const auto evts = data->events;
-  auto& r = internal_r;
+  GameData* data = ctx.data;
+  auto& r = ctx.r;
 
-  //
-  // input events
-  //
-
-  bool button_plus = false;
-  bool button_minus = false;
-
-  for (const SDL_Event& evt : evts) {
-    //
-    // button events
-    //
-    if (evt.type == SDL_EVENT_KEY_DOWN) {
-      const auto scancode = evt.key.scancode;
-      const auto scancode_name = SDL_GetScancodeName(scancode);
-      const auto down = evt.key.down;
-      const auto repeat = evt.key.repeat;
-      SDL_Log("(GameThread)(GameUpdate) KeyDown %s %i %i", scancode_name, down, repeat);
-
-      if (scancode == SDL_SCANCODE_W)
-        keyboard_l.y = -1;
-      if (scancode == SDL_SCANCODE_S)
-        keyboard_l.y = 1;
-      if (scancode == SDL_SCANCODE_A)
-        keyboard_l.x = -1;
-      if (scancode == SDL_SCANCODE_D)
-        keyboard_l.x = 1;
-
-      if (scancode == SDL_SCANCODE_UP)
-        keyboard_r.y = -1;
-      if (scancode == SDL_SCANCODE_DOWN)
-        keyboard_r.y = 1;
-      if (scancode == SDL_SCANCODE_LEFT)
-        keyboard_r.x = -1;
-      if (scancode == SDL_SCANCODE_RIGHT)
-        keyboard_r.x = 1;
-
-      if (scancode == SDL_SCANCODE_SPACE)
-        jump |= true;
-      if (scancode == SDL_SCANCODE_RETURN)
-        pickup |= true;
-
-      if (scancode == SDL_SCANCODE_EQUALS)
-        button_plus = true;
-      if (scancode == SDL_SCANCODE_MINUS)
-        button_minus = true;
-
-      if (scancode == SDL_SCANCODE_KP_9)
-        create_empty<Request_GameOver>(r);
-    }
-    if (evt.type == SDL_EVENT_KEY_UP) {
-      const SDL_KeyboardEvent& k_evt = evt.key;
-      const auto scancode = k_evt.scancode;
-      const auto scancode_name = SDL_GetScancodeName(scancode);
-      const auto down = k_evt.down;
-      const auto repeat = evt.key.repeat;
-      SDL_Log("(GameThread)(GameUpdate) KeyUp %s %i %i", scancode_name, down, repeat);
-
-      if (scancode == SDL_SCANCODE_W)
-        keyboard_l.y = 0;
-      if (scancode == SDL_SCANCODE_S)
-        keyboard_l.y = 0;
-      if (scancode == SDL_SCANCODE_A)
-        keyboard_l.x = 0;
-      if (scancode == SDL_SCANCODE_D)
-        keyboard_l.x = 0;
-
-      if (scancode == SDL_SCANCODE_UP)
-        keyboard_r.y = 0;
-      if (scancode == SDL_SCANCODE_DOWN)
-        keyboard_r.y = 0;
-      if (scancode == SDL_SCANCODE_LEFT)
-        keyboard_r.x = 0;
-      if (scancode == SDL_SCANCODE_RIGHT)
-        keyboard_r.x = 0;
-    }
+  // devices are opened once, then tracked through events
+  if (!input.enumerated) {
+    input.open_devices = !data->replaying;
+    init_input(input);
+  }
+  update_input(input, data->events);
 
-    //
-    // mouse events
-    //
-    if (evt.type == SDL_EVENT_MOUSE_BUTTON_DOWN) {
-      SDL_MouseButtonEvent m_evt = evt.button;
-
-      if (m_evt.button == SDL_BUTTON_LEFT) {
-        // test if you click a shape
-        const auto mouse_pos = data->mouse_pos;
-        auto view = r.view<const PhysicsBodyComponent>();
-        for (const auto& [e, pb_c] : view.each()) {
-          auto shape_ids = get_shapes(pb_c.id);
-          if (b2Shape_TestPoint(shape_ids[0], pixels_to_meters(mouse_pos))) {
-
-            // Destroy now!
-            b2DestroyBody(pb_c.id);
-            r.destroy(e);
-          }
-        }
-      }
+  const auto held = [](const InputAction a) -> float { return action_held(input, a) ? 1.0f : 0.0f; };
+  keyboard_l.x = held(InputAction::MOVE_RIGHT) - held(InputAction::MOVE_LEFT);
+  keyboard_l.y = held(InputAction::MOVE_DOWN) - held(InputAction::MOVE_UP);
+  keyboard_r.x = held(InputAction::CAMERA_RIGHT) - held(InputAction::CAMERA_LEFT);
+  keyboard_r.y = held(InputAction::CAMERA_DOWN) - held(InputAction::CAMERA_UP);
+  controller_l = { input_axis(input, InputAxis::MOVE_X), input_axis(input, InputAxis::MOVE_Y) };
+  controller_r = { input_axis(input, InputAxis::CAMERA_X), input_axis(input, InputAxis::CAMERA_Y) };
 
-      if (m_evt.button == SDL_BUTTON_RIGHT) {
-        spawn(data, data->mouse_pos, { 50, 50 }, { 1.0, 1.0, 1.0 });
-      }
-    }
+  jump |= action_pressed(input, InputAction::JUMP);
+  pickup |= action_pressed(input, InputAction::PICKUP);
 
-    //
-    // joysticks
-    //
-    if (evt.type == SDL_EVENT_JOYSTICK_ADDED) {
-      auto joystick_id = evt.jdevice.which;
-      SDL_Log("Joystick Added: %i", joystick_id);
-
-      // open as gamepad?
-      if (SDL_IsGamepad(joystick_id)) {
-        SDL_Log("tried to add as gamepad.");
-        SDL_Gamepad* gamepad = SDL_OpenGamepad(joystick_id);
-        if (gamepad)
-          SDL_Log("gamepad: success?");
-        else
-          SDL_Log("gamepad: fail?");
-      }
-    }
-    if (evt.type == SDL_EVENT_JOYSTICK_REMOVED) {
-      auto joystick_id = evt.jdevice.which;
-      SDL_Log("Joystick Removed: %i", joystick_id);
-      // TODO: remove from some list or other
-    }
-    if (evt.type == SDL_EVENT_JOYSTICK_BUTTON_DOWN) {
-      SDL_Log("Joystick button down");
-    }
-    if (evt.type == SDL_EVENT_JOYSTICK_BUTTON_UP) {
-      SDL_Log("Joystick button up");
-    }
-  }
+  if (action_pressed(input, InputAction::PICK))
+    publish(*data->bus, PickRequestEvent{ .pos = data->mouse_pos });
+  if (action_pressed(input, InputAction::SPAWN))
+    publish(*data->bus, SpawnRequestEvent{ .pos = data->mouse_pos });
+
+  if (action_pressed(input, InputAction::FORCE_GAMEOVER))
+    create_empty<Request_GameOver>(r);
+
+  // applied between physics steps
+  save_requested |= action_pressed(input, InputAction::QUICKSAVE);
+  load_requested |= action_pressed(input, InputAction::QUICKLOAD);
+  agents_requested |= action_pressed(input, InputAction::SPAWN_AGENTS);
 
   auto& ui_data = data->ui_data;
   ui_data.keyboard_l = keyboard_l;
   ui_data.keyboard_r = keyboard_r;
-
-  int n_joysticks = 0;
-  auto* joysticks = SDL_GetJoysticks(&n_joysticks);
-  ui_data.n_controllers = n_joysticks;
-  ui_data.controller_l = { 0, 0 };
-  ui_data.controller_r = { 0, 0 };
-
-  for (int i = 0; i < n_joysticks; i++) {
-    const SDL_JoystickID id = joysticks[i];
-    const auto instance = SDL_GetJoystickFromID(id);
-
-    const auto lx_raw = SDL_GetJoystickAxis(instance, SDL_GAMEPAD_AXIS_LEFTX);
-    const auto ly_raw = SDL_GetJoystickAxis(instance, SDL_GAMEPAD_AXIS_LEFTY);
-    const auto rx_raw = SDL_GetJoystickAxis(instance, SDL_GAMEPAD_AXIS_RIGHTX);
-    const auto ry_raw = SDL_GetJoystickAxis(instance, SDL_GAMEPAD_AXIS_RIGHTY);
-
-    const auto lx_nrm = scale(lx_raw, -32768, 32767, -1.0f, 1.0f);
-    const auto ly_nrm = scale(ly_raw, -32768, 32767, -1.0f, 1.0f);
-    const auto rx_nrm = scale(rx_raw, -32768, 32767, -1.0f, 1.0f);
-    const auto ry_nrm = scale(ry_raw, -32768, 32767, -1.0f, 1.0f);
-    const vec2 inp_l = vec2{ lx_nrm, ly_nrm };
-    const vec2 inp_r = vec2{ rx_nrm, ry_nrm };
-    controller_l = inp_l;
-    controller_r = inp_r;
-
-    const float epsilon = 0.01f;
-    if (abs(controller_l.x) < epsilon)
-      controller_l.x = 0.0f;
-    if (abs(controller_l.y) < epsilon)
-      controller_l.y = 0.0f;
-    if (abs(controller_r.x) < epsilon)
-      controller_r.x = 0.0f;
-    if (abs(controller_r.y) < epsilon)
-      controller_r.y = 0.0f;
-
-    // generate inputs for one button.
-    static bool s_press = false;
-    static bool s_held_last_frame = false;
-    static bool s_held = false;
-    static bool s_release = false;
-    s_press = false;
-    s_release = false;
-    s_held = SDL_GetJoystickButton(instance, SDL_GAMEPAD_BUTTON_SOUTH);
-    if (s_held_last_frame && !s_held)
-      s_release = true;
-    if (!s_held_last_frame && s_held)
-      s_press = true;
-    s_held_last_frame = s_held;
-    if (s_press)
-      SDL_Log("south button pressed");
-    // jump |= s_press;
-    pickup |= s_press;
-
-    ui_data.controller_l.x = lx_nrm;
-    ui_data.controller_l.y = ly_nrm;
-    ui_data.controller_r.x = rx_nrm;
-    ui_data.controller_r.y = ry_nrm;
-    break;
-  }
+  ui_data.physics_pipelined = data->physics->pipelined;
+  ui_data.n_controllers = input.n_devices;
+  ui_data.controller_l = controller_l;
+  ui_data.controller_r = controller_r;
 
   l_input = keyboard_l + controller_l;
   r_input = keyboard_r + controller_r;
@@ -524,6 +470,12 @@ game_update(GameData* data)
   l_input.y = std::clamp(l_input.y, -1.0f, 1.0f);
   r_input.x = std::clamp(r_input.x, -1.0f, 1.0f);
   r_input.y = std::clamp(r_input.y, -1.0f, 1.0f);
+}
+
+void
+update_camera_system(SystemContext& ctx)
+{
+  GameData* data = ctx.data;
 
   // set camera to position of transform
   // auto view = r.view<const PhysicsBodyComponent, const TransformComponent>();
@@ -538,24 +490,14 @@ game_update(GameData* data)
   // update camera with right analogue
   camera_pos = camera_pos + data->dt * camera_speed * r_input;
   data->camera_pos = camera_pos;
+  data->camera_velocity = camera_speed * r_input;
+}
 
-  // Update transforms via physics body.
-  update_transforms_from_physics(r);
-
-  // update_events_system()
-  SINGLE_Events::get().dispatcher.update();
-
-  // check what you're colliding with.
-  // if it's a producer: you gain 1 item.
-  // if it's a consumer, you lose 1 item.
-  if (jump) {
-    // TODO
-    // b2Shape_TestPoint(b2ShapeId shapeId, b2Vec2 point)
-  }
-
-  //
-  // systems
-  //
+void
+update_gameover_system(SystemContext& ctx)
+{
+  GameData* data = ctx.data;
+  auto& r = ctx.r;
 
   // process ui data.
   const auto view = r.view<const Request_GameOver>();
@@ -566,23 +508,97 @@ game_update(GameData* data)
     game_refresh(data);
     game_init(data);
   }
+}
 
-  // populate ui data from the gamethread????
-  {
-    auto& hmm = ui_data.hmm;
-    hmm.clear(); // .clear() is bad
-    const auto view = r.view<const TransformComponent, const ColourComponent, const InventoryComponent>();
-    for (const auto& [e, t_c, col_c, inv_c] : view.each())
-      hmm.push_back(UIEntity{ .entity = e, .renderable = { .transform = t_c, .colour = col_c }, .inventory = inv_c });
-
-    ui_data.play_again = false;
-    ui_data.game_over = gameover;
-  }
+// populate ui data from the gamethread
+void
+update_ui_model_system(SystemContext& ctx)
+{
+  const auto& r = std::as_const(ctx.r);
+  auto& ui_data = ctx.data->ui_data;
+
+  // only entries whose components changed are rebuilt
+  update_ui_model(r, ui_model, ui_data, ctx.data->make_ui_snapshot);
+
+  ui_data.play_again = false;
+  ui_data.game_over = r.view<const Request_GameOver>().size() > 0;
+}
+
+void
+init_update_schedule(SystemSchedule& schedule)
+{
+  // reads SDL and joysticks. KP_9 creates a Request_GameOver.
+  add_system(schedule,
+             { .name = "input",
+               .fn = update_input_system,
+               .access = make_access(Reads<>{}, Writes<Res_Input, Res_UiData>{}),
+               .main_thread = true,
+               .structural = true });
+
+  add_system(schedule,
+             { .name = "camera",
+               .fn = update_camera_system,
+               .access = make_access(Reads<Res_Input>{}, Writes<Res_Camera>{}) });
+
+  add_system(schedule,
+             { .name = "particles",
+               .fn = [](SystemContext& ctx) {
+                 update_particles_system(ctx.r, internal_particles, particles_rnd, ctx.data->dt);
+               },
+               .access = make_access(Reads<TransformComponent>{}, Writes<ParticleEmitterComponent, Res_Particles>{}) });
+
+  // can clear the registry
+  add_system(schedule,
+             { .name = "gameover",
+               .fn = update_gameover_system,
+               .access = make_access(Reads<Request_GameOver, Res_UiData>{}, Writes<>{}),
+               .main_thread = true,
+               .structural = true });
+
+  add_system(schedule,
+             { .name = "flow_field",
+               .fn = [](SystemContext& ctx) { update_flow_field_system(ctx, flow_field); },
+               .access = make_access(Reads<TransformComponent, ContainerReceiverComponent, NavObstacleComponent>{},
+                                     Writes<Res_FlowField>{}) });
+
+  add_system(schedule,
+             { .name = "flow_agents",
+               .fn = [](SystemContext& ctx) { update_flow_agents_system(ctx, flow_field.field); },
+               .access = make_access(Reads<TransformComponent, Res_FlowField>{}, Writes<FlowAgentComponent>{}) });
+
+  add_system(schedule,
+             { .name = "ui_model",
+               .fn = update_ui_model_system,
+               .access = make_access(Reads<TransformComponent, ColourComponent, InventoryComponent, Request_GameOver>{},
+                                     Writes<Res_UiData>{}) });
+}
+
+void
+game_update(GameData* data)
+{
+  auto& r = internal_r;
+  if (update_schedule.systems.empty())
+    init_update_schedule(update_schedule);
+
+  SystemContext ctx{ .r = r, .data = data, .jobs = data->jobs };
+  run_schedule(update_schedule, ctx);
+
+  auto& ui_data = data->ui_data;
+  export_schedule_ui(update_schedule, ui_data.schedule);
+  ui_data.schedule_critical_ms = (float)(1e-6 * (double)update_schedule.critical_path_ns);
+  ui_data.schedule_total_ms = (float)(1e-6 * (double)update_schedule.total_ns);
+
+  ui_data.n_flow_agents = (int)r.storage<FlowAgentComponent>().size();
+  ui_data.flow_rebuilds = flow_field.field.n_rebuilds;
+  ui_data.flow_incremental = flow_field.field.n_incremental;
+  ui_data.flow_last_touched = flow_field.field.last_touched;
 };
 
 void
 game_update_ui(GameUIData* ui_data)
 {
+  // imgui's allocator is per module too. must match the engine's, as the context is shared
+  ImGui::SetAllocatorFunctions(imgui_tracked_alloc, imgui_tracked_free, ui_data->memory);
   ImGui::SetCurrentContext(ui_data->ctx);
   const auto& data = ui_data->ui_data;
 
@@ -604,9 +620,67 @@ game_update_ui(GameUIData* ui_data)
     ImGui::Text("(RenderThread) FPS: %0.2f", ImGui::GetIO().Framerate);
     ImGui::Text("contact events: %i", data.n_contact_events);
     ImGui::Text("sensor events: %i", data.n_sensor_events);
+    ImGui::Text("bodies active: %i inactive: %i", data.n_active_bodies, data.n_inactive_bodies);
+    ImGui::Text("physics: %s", data.physics_pipelined ? "pipelined" : "sequential");
+    ImGui::Text("flow agents: %i (G spawns more)", data.n_flow_agents);
+    ImGui::Text("flow field: %u rebuilds %u incremental, last touched %u tiles",
+                data.flow_rebuilds,
+                data.flow_incremental,
+                data.flow_last_touched);
     ImGui::Text("renderables: %i", (int)ui_data->renderable.size());
-    ImGui::Text("ui data hmm: %i", (int)ui_data->ui_data.hmm.size());
+    ImGui::Text("particles: %i", ui_data->n_particles);
+    const auto& model = ui_data->ui_data.ui_model;
+    ImGui::Text("ui model: %i (v%llu)",
+                model.entities ? (int)model.entities->size() : 0,
+                (unsigned long long)model.version);
     ImGui::Text("camera_pos: %0.2f, %0.2f", ui_data->camera_pos.x, ui_data->camera_pos.y);
+
+    // frame arenas. the heap count is allocations that did not fit
+    const auto arena_text = [](const char* label, const FrameArenaStats& stats) {
+      ImGui::Text("%s arena: %zu KB peak: %zu / %zu KB heap: %u",
+                  label,
+                  stats.last_frame_bytes / 1024,
+                  stats.peak / 1024,
+                  stats.capacity / 1024,
+                  stats.n_fallback);
+    };
+    arena_text("(GameThread)", data.game_arena);
+    arena_text("(RenderThread)", data.render_arena);
+    ImGui::End();
+  }
+
+  // input to submit, for the oldest input in each batch
+  {
+    const InputLatencyStats& stats = data.input_latency;
+    auto flags = 0;
+    flags |= ImGuiWindowFlags_AlwaysAutoResize;
+    ImGui::Begin("InputLatency", nullptr, flags);
+    ImGui::Text("samples: %u (%llu total)", stats.n_samples, (unsigned long long)stats.n_total);
+    ImGui::Checkbox("late camera", &ui_data->late_camera);
+
+    if (ImGui::BeginTable("latency", 5, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg)) {
+      ImGui::TableSetupColumn("stage");
+      ImGui::TableSetupColumn("p50 ms");
+      ImGui::TableSetupColumn("p95 ms");
+      ImGui::TableSetupColumn("p99 ms");
+      ImGui::TableSetupColumn("max ms");
+      ImGui::TableHeadersRow();
+      for (size_t i = 0; i < LATENCY_STAGE_COUNT; i++) {
+        const LatencyPercentiles& p = stats.stages[i];
+        ImGui::TableNextRow();
+        ImGui::TableNextColumn();
+        ImGui::Text("%s", latency_stage_name((LatencyStage)i));
+        ImGui::TableNextColumn();
+        ImGui::Text("%0.2f", p.p50_ms);
+        ImGui::TableNextColumn();
+        ImGui::Text("%0.2f", p.p95_ms);
+        ImGui::TableNextColumn();
+        ImGui::Text("%0.2f", p.p99_ms);
+        ImGui::TableNextColumn();
+        ImGui::Text("%0.2f", p.max_ms);
+      }
+      ImGui::EndTable();
+    }
     ImGui::End();
   }
 
@@ -633,6 +707,141 @@ game_update_ui(GameUIData* ui_data)
     ImGui::End();
   }
 
+  // fixed step telemetry
+  {
+    const FixedStepStats& stats = data.fixed_step;
+    auto flags = 0;
+    flags |= ImGuiWindowFlags_AlwaysAutoResize;
+    ImGui::Begin("FixedStep", nullptr, flags);
+
+    ImGui::Text("tick rate: %0.1f hz (%0.3f ms)", stats.tick_hz, 1000.0f / stats.tick_hz);
+    ImGui::Text("steps last frame: %i / %i", stats.steps_last_frame, stats.max_steps_per_frame);
+    ImGui::Text("time dilation: %0.3f", stats.time_dilation);
+    ImGui::Text("ticks: %llu over budget: %llu dropped: %llu",
+                (unsigned long long)stats.n_ticks,
+                (unsigned long long)stats.n_over_budget,
+                (unsigned long long)stats.n_dropped);
+
+    std::array<float, N_TICK_HISTOGRAM_BUCKETS> buckets;
+    for (int i = 0; i < N_TICK_HISTOGRAM_BUCKETS; i++)
+      buckets[i] = (float)stats.histogram[i];
+    ImGui::PlotHistogram("tick us (log2)", buckets.data(), N_TICK_HISTOGRAM_BUCKETS, 0, nullptr, 0.0f, FLT_MAX, { 0, 60 });
+
+    static float tick_hz = 60.0f;
+    ImGui::SliderFloat("##tick_hz", &tick_hz, 10.0f, 240.0f, "%0.0f hz");
+    ImGui::SameLine();
+    if (ImGui::Button("Set tick rate"))
+      ui_data->ui_data.requested_tick_hz = tick_hz;
+
+    ImGui::End();
+  }
+
+  // gamethread system schedule
+  {
+    auto flags = 0;
+    flags |= ImGuiWindowFlags_AlwaysAutoResize;
+    ImGui::Begin("Schedule", nullptr, flags);
+    ImGui::Text("critical path: %0.3fms total: %0.3fms", data.schedule_critical_ms, data.schedule_total_ms);
+
+    if (ImGui::BeginTable("systems", 4, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg)) {
+      ImGui::TableSetupColumn("batch");
+      ImGui::TableSetupColumn("system");
+      ImGui::TableSetupColumn("ms");
+      ImGui::TableSetupColumn("thread");
+      ImGui::TableHeadersRow();
+      for (const SystemTimingUi& sys : data.schedule) {
+        ImGui::TableNextRow();
+        ImGui::TableNextColumn();
+        ImGui::Text("%i", sys.batch);
+        ImGui::TableNextColumn();
+        if (sys.critical)
+          ImGui::TextColored({ 1.0f, 0.5f, 0.2f, 1.0f }, "%s", sys.name); // on the critical path
+        else
+          ImGui::Text("%s", sys.name);
+        ImGui::TableNextColumn();
+        ImGui::Text("%0.3f", sys.ms);
+        ImGui::TableNextColumn();
+        ImGui::Text("%s", sys.main_thread ? "game" : "worker");
+      }
+      ImGui::EndTable();
+    }
+    ImGui::End();
+  }
+
+  // event bus, counts are for the last frame
+  {
+    auto flags = 0;
+    flags |= ImGuiWindowFlags_AlwaysAutoResize;
+    ImGui::Begin("Events", nullptr, flags);
+
+    if (ImGui::BeginTable("events", 5, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg)) {
+      ImGui::TableSetupColumn("event");
+      ImGui::TableSetupColumn("published");
+      ImGui::TableSetupColumn("consumed");
+      ImGui::TableSetupColumn("dropped");
+      ImGui::TableSetupColumn("pending");
+      ImGui::TableHeadersRow();
+      for (const EventStatsUi& evt : data.events) {
+        ImGui::TableNextRow();
+        ImGui::TableNextColumn();
+        ImGui::Text("%s", evt.name);
+        ImGui::TableNextColumn();
+        ImGui::Text("%u", evt.counts.published);
+        ImGui::TableNextColumn();
+        ImGui::Text("%u", evt.counts.consumed);
+        ImGui::TableNextColumn();
+        if (evt.counts.dropped > 0)
+          ImGui::TextColored({ 1.0f, 0.3f, 0.3f, 1.0f }, "%u", evt.counts.dropped);
+        else
+          ImGui::Text("0");
+        ImGui::TableNextColumn();
+        ImGui::Text("%u/%u", evt.pending, evt.capacity);
+      }
+      ImGui::EndTable();
+    }
+    ImGui::End();
+  }
+
+  // tracked allocators, per subsystem
+  {
+    const MemoryStats& memory = data.memory;
+    auto flags = 0;
+    flags |= ImGuiWindowFlags_AlwaysAutoResize;
+    ImGui::Begin("Memory", nullptr, flags);
+
+    if (ImGui::BeginTable("memory", 5, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg)) {
+      ImGui::TableSetupColumn("tag");
+      ImGui::TableSetupColumn("live KB");
+      ImGui::TableSetupColumn("peak KB");
+      ImGui::TableSetupColumn("budget KB");
+      ImGui::TableSetupColumn("allocs");
+      ImGui::TableHeadersRow();
+      for (size_t i = 0; i < MEMORY_TAG_COUNT; i++) {
+        const MemoryTagStats& tag = memory.tags[i];
+        const bool over = tag.n_over_budget > 0;
+        ImGui::TableNextRow();
+        ImGui::TableNextColumn();
+        ImGui::Text("%s", memory_tag_name((MemoryTag)i));
+        ImGui::TableNextColumn();
+        ImGui::Text("%zu", tag.live / 1024);
+        ImGui::TableNextColumn();
+        if (over)
+          ImGui::TextColored({ 1.0f, 0.3f, 0.3f, 1.0f }, "%zu", tag.peak / 1024);
+        else
+          ImGui::Text("%zu", tag.peak / 1024);
+        ImGui::TableNextColumn();
+        ImGui::Text("%zu", tag.budget / 1024);
+        ImGui::TableNextColumn();
+        ImGui::Text("%u", tag.n_live);
+      }
+      ImGui::EndTable();
+    }
+
+    // used is rounded up to the size class, so reserved - used is what the pools hold on to
+    ImGui::Text("pools: %zu KB used / %zu KB reserved", memory.pool_used / 1024, memory.pool_reserved / 1024);
+    ImGui::End();
+  }
+
   // systems
   update_ui_gameover_system(ui_data->ui_data);
 
@@ -651,16 +860,22 @@ game_update_ui(GameUIData* ui_data)
     ImGui::Begin("overlay", 0, flags);
 
     const auto camera_p = ui_data->camera_pos;
-    for (const auto& ui : ui_data->ui_data.hmm) {
+    // labels are formatted in to the renderthread's frame arena
+    std::pmr::string txt(frame_resource(*ui_data->frame_arena));
+    // holding the pointer keeps the snapshot alive while drawing
+    static const std::vector<UIEntity> no_entities;
+    const auto entities = ui_data->ui_data.ui_model.entities;
+    for (const auto& ui : entities ? *entities : no_entities) {
       // ImGui::PushID(eid);
 
       const auto pos = ui.renderable.transform.pos;
       const auto ss_pos = worldspace_to_screenspace(camera_p, pos, screen_size);
       ImGui::SetCursorScreenPos({ ss_pos.x, ss_pos.y });
 
-      // const auto txt = std::format("eid: {} \n items: {}", (uint32_t)ui.entity, ui.inventory.items);
-      const auto txt = std::format("items: {}", ui.inventory.items);
-      ImGui::Text("%s", txt.c_str());
+      // const auto txt = std::format("eid: {} \n items: {}", (uint32_t)ui.entity, ui.inventory.count);
+      txt.clear();
+      std::format_to(std::back_inserter(txt), "items: {}/{}", ui.inventory.count, ui.inventory.capacity);
+      ImGui::TextUnformatted(txt.data(), txt.data() + txt.size());
 
       // ImGui::PopID();
     }
@@ -676,8 +891,21 @@ game_refresh(GameData* data)
   SDL_Log("(GameEngine) game_refresh()");
   refreshed = true;
 
+  // the world could still be stepping. clearing the registry calls in to box2d
+  wait_physics_step(*data->physics);
+
   // clear the registry
   internal_r.clear();
+  clear_ui_model(ui_model);
+  clear_inventory_pool(internal_r);
+  inventory_transfers.clear();
+  clear_particles(internal_particles);
+  destroy_queue.entities.clear();
+  clear_events<PickRequestEvent>(*data->bus);
+  clear_events<SpawnRequestEvent>(*data->bus);
+  collision_events.enter.clear();
+  collision_events.exit.clear();
+  physics_activity.cursor = 0;
 
   // Delete the physics world. Create another one.
   b2DestroyWorld(data->world_id);
@@ -9,27 +9,38 @@
 namespace game2d {
 
 void
-update_transforms_from_physics(entt::registry& r)
+update_transforms_from_physics(Registry& r)
 {
   const auto view = r.view<const PhysicsBodyComponent, TransformComponent>();
   for (const auto& [e, pb_c, t_c] : view.each()) {
-
     const auto id = pb_c.id;
-    const auto b2_pos = b2Body_GetPosition(id);
-    const auto shape_ids = get_shapes(id);
-
-    b2AABB aabb = b2Shape_GetAABB(shape_ids[0]); // assume every body has a shape
-    for (int i = 1; i < shape_ids.size(); i++)
-      aabb = b2AABB_Union(aabb, b2Shape_GetAABB(shape_ids[i]));
-
-    const float w = aabb.upperBound.x - aabb.lowerBound.x;
-    const float h = aabb.upperBound.y - aabb.lowerBound.y;
-    const vec2 pos_in_pixels = meters_to_pixels(b2_pos);
-    const vec2 size_in_pixels = meters_to_pixels({ w, h });
-    const vec2 pos_tl = pos_in_pixels - (0.5f * size_in_pixels);
-    t_c.pos = pos_tl;
-    t_c.size = size_in_pixels;
+    const b2Vec2 b2_pos = b2Body_GetPosition(id);
+    t_c.pos = meters_to_pixels(b2Add(b2_pos, pb_c.local_aabb.lowerBound));
+    t_c.size = meters_to_pixels(b2Sub(pb_c.local_aabb.upperBound, pb_c.local_aabb.lowerBound));
     t_c.rotation_radians = b2Rot_GetAngle(b2Body_GetRotation(id));
+    r.patch<TransformComponent>(e);
+  }
+}
+
+void
+update_transforms_from_body_events(Registry& r, const b2WorldId world_id)
+{
+  // only bodies that moved last step are reported.
+  // static and sleeping bodies keep their last transform.
+  const b2BodyEvents events = b2World_GetBodyEvents(world_id);
+  for (int i = 0; i < events.moveCount; i++) {
+    const b2BodyMoveEvent& evt = events.moveEvents[i];
+    const auto e = (entt::entity)(reinterpret_cast<uintptr_t>(evt.userData));
+    if (!r.valid(e))
+      continue;
+
+    // extents are cached on the body, and bodies have fixed rotation.
+    // patched, so listeners (e.g. the ui model) see the move.
+    const auto& pb_c = r.get<const PhysicsBodyComponent>(e);
+    r.patch<TransformComponent>(e, [&](TransformComponent& t_c) {
+      t_c.pos = meters_to_pixels(b2Add(evt.transform.p, pb_c.local_aabb.lowerBound));
+      t_c.rotation_radians = b2Rot_GetAngle(evt.transform.q);
+    });
   }
 }
 
@@ -1,14 +1,18 @@
 #pragma once
 
+#include "core/registry.hpp"
+
 #include <box2d/id.h>
 #include <entt/fwd.hpp>
 
 namespace game2d {
 
-std::vector<b2ShapeId>
-get_shapes(b2BodyId id);
+// syncs every body. slow, use on init.
+void
+update_transforms_from_physics(Registry& r);
 
+// syncs only the bodies that moved during the last b2World_Step()
 void
-update_transforms_from_physics(entt::registry& r);
+update_transforms_from_body_events(Registry& r, const b2WorldId world_id);
 
 } // namespace game2d
\ No newline at end of file
@@ -0,0 +1,87 @@
+#include "core/pch.hpp"
+
+#include "collisions_system.hpp"
+
+#include "actors/actor_player/actor_player_components.hpp"
+#include "core/box2d/box2d_components.hpp"
+#include "systems/system_items/items_components.hpp"
+
+namespace game2d {
+
+static CollisionMasks collision_masks{};
+
+template<typename Tag, typename Removed>
+static bool
+has_tag(const Registry& r, const entt::entity e)
+{
+  if constexpr (std::is_same_v<Tag, Removed>)
+    return false;
+  else
+    return r.all_of<Tag>(e);
+};
+
+// Removed is the tag being removed. on_destroy runs while it is still there
+template<typename Removed = void>
+static CollisionCategory
+collision_category(const Registry& r, const entt::entity e)
+{
+  if (has_tag<PlayerComponent, Removed>(r, e))
+    return CollisionCategory::PLAYER;
+  if (has_tag<ContainerProviderComponent, Removed>(r, e))
+    return CollisionCategory::CONTAINER_PROVIDER;
+  if (has_tag<ContainerReceiverComponent, Removed>(r, e))
+    return CollisionCategory::CONTAINER_RECEIVER;
+  return CollisionCategory::DEFAULT;
+};
+
+static void
+update_shape_filters(Registry& r, const entt::entity e, const CollisionCategory category)
+{
+  // the tag can be emplaced before the body
+  const auto* pb_c = r.try_get<const PhysicsBodyComponent>(e);
+  if (pb_c == nullptr)
+    return;
+
+  for (int i = 0; i < pb_c->n_shapes; i++) {
+    const b2ShapeId shape_id = pb_c->shape_ids[i];
+    if (!b2Shape_IsValid(shape_id)) // the body is destroyed before the entity
+      continue;
+    apply_collision_filter(shape_id, category, collision_masks);
+  }
+};
+
+template<typename Tag>
+static void
+on_tag_removed(Registry& r, const entt::entity e)
+{
+  update_shape_filters(r, e, collision_category<Tag>(r, e));
+};
+
+CollisionCategory
+get_collision_category(const Registry& r, const entt::entity e)
+{
+  return collision_category(r, e);
+};
+
+void
+init_collision_filters(Registry& r, const CollisionMasks& masks)
+{
+  collision_masks = masks;
+
+  // entt ignores a free function that is already connected
+  r.on_construct<PhysicsBodyComponent>().connect<&update_collision_filter>();
+  r.on_construct<PlayerComponent>().connect<&update_collision_filter>();
+  r.on_construct<ContainerProviderComponent>().connect<&update_collision_filter>();
+  r.on_construct<ContainerReceiverComponent>().connect<&update_collision_filter>();
+  r.on_destroy<PlayerComponent>().connect<&on_tag_removed<PlayerComponent>>();
+  r.on_destroy<ContainerProviderComponent>().connect<&on_tag_removed<ContainerProviderComponent>>();
+  r.on_destroy<ContainerReceiverComponent>().connect<&on_tag_removed<ContainerReceiverComponent>>();
+};
+
+void
+update_collision_filter(Registry& r, const entt::entity e)
+{
+  update_shape_filters(r, e, collision_category(r, e));
+};
+
+} // namespace game2d
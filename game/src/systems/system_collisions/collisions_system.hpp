@@ -0,0 +1,22 @@
+#pragma once
+
+#include "core/box2d/box2d_categories.hpp"
+#include "core/registry.hpp"
+
+#include <entt/entt.hpp>
+
+namespace game2d {
+
+CollisionCategory
+get_collision_category(const Registry& r, const entt::entity e);
+
+// Keeps the b2Filter of each body in sync with its tag components, as they are added and removed.
+// masks[category] is every category that category has a handler with.
+// See apply_collision_filter() for what that does to each shape.
+void
+init_collision_filters(Registry& r, const CollisionMasks& masks);
+
+void
+update_collision_filter(Registry& r, const entt::entity e);
+
+} // namespace game2d
@@ -0,0 +1,16 @@
+#pragma once
+
+#include <entt/entt.hpp>
+
+#include <vector>
+
+namespace game2d {
+
+// Entities are not destroyed while something may be iterating a view.
+// They are queued, then flushed at a safe point in the frame.
+struct DestroyQueue
+{
+  std::vector<entt::entity> entities;
+};
+
+} // namespace game2d
@@ -0,0 +1,46 @@
+#include "core/pch.hpp"
+
+#include "destroy_system.hpp"
+
+#include "core/box2d/box2d_components.hpp"
+#include "core/box2d/box2d_helpers.hpp"
+
+namespace game2d {
+
+void
+enqueue_destroy(DestroyQueue& queue, const entt::entity e)
+{
+  queue.entities.push_back(e);
+}
+
+void
+flush_destroy_queue(Registry& r, DestroyQueue& queue)
+{
+  auto& entities = queue.entities;
+  if (entities.empty())
+    return;
+
+  // the same entity could have been queued twice
+  std::sort(entities.begin(), entities.end());
+  entities.erase(std::unique(entities.begin(), entities.end()), entities.end());
+
+  for (const entt::entity e : entities) {
+    if (!r.valid(e))
+      continue;
+
+    if (const auto* pb_c = r.try_get<const PhysicsBodyComponent>(e)) {
+      for (int i = 0; i < pb_c->n_shapes; i++) {
+        const auto shape_e = get_entity_from_shape_id(pb_c->shape_ids[i]);
+        if (r.valid(shape_e))
+          r.destroy(shape_e);
+      }
+      b2DestroyBody(pb_c->id); // destroys the shapes
+    }
+
+    r.destroy(e);
+  }
+
+  entities.clear();
+}
+
+} // namespace game2d
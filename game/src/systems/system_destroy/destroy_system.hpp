@@ -0,0 +1,17 @@
+#pragma once
+
+#include "core/registry.hpp"
+#include "destroy_components.hpp"
+
+#include <entt/fwd.hpp>
+
+namespace game2d {
+
+void
+enqueue_destroy(DestroyQueue& queue, const entt::entity e);
+
+// destroys queued entities, their physics bodies, and their shape entities
+void
+flush_destroy_queue(Registry& r, DestroyQueue& queue);
+
+} // namespace game2d
@@ -1,17 +1,29 @@
 #pragma once
 
-#include "core/singleton.hpp"
-
-#include <entt/fwd.hpp>
-#include <entt/signal/dispatcher.hpp>
+#include "core/events/event_bus.hpp"
+#include "core/maths/vec.hpp"
 
 namespace game2d {
 
-struct SINGLE_Events : public Singleton<SINGLE_Events>
+// published by input, consumed between physics steps
+
+// destroy whatever is under the point
+struct PickRequestEvent
 {
-  entt::dispatcher dispatcher;
+  vec2 pos{ 0, 0 };
+};
 
-  SINGLE_Events() = default;
+// spawn a crate at the point
+struct SpawnRequestEvent
+{
+  vec2 pos{ 0, 0 };
+};
+
+inline void
+register_game_events(EventBus& bus)
+{
+  register_event<PickRequestEvent>(bus, "pick_request", 64);
+  register_event<SpawnRequestEvent>(bus, "spawn_request", 1024);
 };
 
-} // namespace game2d
\ No newline at end of file
+} // namespace game2d
@@ -0,0 +1,35 @@
+#pragma once
+
+#include "core/maths/vec.hpp"
+#include "core/navigation/flow_field.hpp"
+
+#include <vector>
+
+namespace game2d {
+
+// the tiles under it are walls in the flow field
+struct NavObstacleComponent
+{
+  bool placeholder = true;
+};
+
+// steers along the flow field, towards the receiver
+struct FlowAgentComponent
+{
+  float speed = 100.0f; // pixels per second
+  vec2 velocity{ 0, 0 }; // sampled by the gamethread, given to the body between physics steps
+};
+
+struct FlowFieldState
+{
+  FlowField field;
+  int goal = -1;
+
+  // set by the obstacle signals. the walls are found again on the next update.
+  bool obstacles_dirty = true;
+
+  // scratch, kept between calls
+  std::vector<uint8_t> costs;
+};
+
+} // namespace game2d
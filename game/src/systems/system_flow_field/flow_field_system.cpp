@@ -0,0 +1,108 @@
+#include "core/pch.hpp"
+
+#include "flow_field_system.hpp"
+
+#include "core/box2d/box2d_components.hpp"
+#include "core/box2d/box2d_helpers.hpp"
+#include "systems/system_items/items_components.hpp"
+#include "systems/system_physics_activity/physics_activity_components.hpp"
+
+namespace game2d {
+
+static void
+mark_obstacles_dirty(FlowFieldState& state, Registry& r, const entt::entity e)
+{
+  state.obstacles_dirty = true;
+};
+
+void
+init_flow_field_system(Registry& r, FlowFieldState& state, const int width, const int height, const int cell_size)
+{
+  init_flow_field(state.field, width, height, cell_size, { 0, 0 });
+  state.goal = -1;
+  state.obstacles_dirty = true;
+
+  // entt ignores a listener that is already connected
+  r.on_construct<NavObstacleComponent>().connect<&mark_obstacles_dirty>(state);
+  r.on_destroy<NavObstacleComponent>().connect<&mark_obstacles_dirty>(state);
+};
+
+// only the tiles that differ are queued, so the update stays incremental
+static void
+update_obstacles(const Registry& r, FlowFieldState& state)
+{
+  FlowField& field = state.field;
+  state.costs.assign(field.costs.size(), FLOW_COST_OPEN);
+
+  const auto view = r.view<const NavObstacleComponent, const TransformComponent>();
+  for (const auto& [e, t_c] : view.each()) {
+    ivec2 min;
+    ivec2 max;
+    if (!flow_field_rect_tiles(field, t_c.pos, t_c.size, min, max))
+      continue;
+    for (int y = min.y; y <= max.y; y++)
+      for (int x = min.x; x <= max.x; x++)
+        state.costs[grid_position_to_index({ x, y }, field.width)] = FLOW_COST_WALL;
+  }
+
+  for (size_t i = 0; i < state.costs.size(); i++)
+    if (state.costs[i] != field.costs[i])
+      set_flow_cost(field, (int)i, state.costs[i]);
+};
+
+void
+update_flow_field_system(SystemContext& ctx, FlowFieldState& state)
+{
+  const auto& r = std::as_const(ctx.r);
+
+  // one goal, the receiver. it can be pushed about, which rebuilds the field.
+  int goal = -1;
+  const auto view = r.view<const ContainerReceiverComponent, const TransformComponent>();
+  for (const auto& [e, t_c] : view.each()) {
+    goal = flow_field_index(state.field, t_c.pos + 0.5f * t_c.size);
+    break;
+  }
+  if (goal != state.goal) {
+    state.goal = goal;
+    if (goal >= 0)
+      set_flow_goals(state.field, { &goal, 1 });
+    else
+      set_flow_goals(state.field, {});
+  }
+
+  if (state.obstacles_dirty) {
+    state.obstacles_dirty = false;
+    update_obstacles(r, state);
+  }
+
+  update_flow_field(state.field, ctx);
+};
+
+void
+update_flow_agents_system(SystemContext& ctx, const FlowField& field)
+{
+  auto& agents = ctx.r.storage<FlowAgentComponent>();
+  const auto& transforms = ctx.r.storage<TransformComponent>();
+
+  // one tile per agent, no searching
+  parallel_for(ctx, (uint32_t)agents.size(), 1024, [&](uint32_t start, uint32_t end) {
+    for (uint32_t i = start; i < end; i++) {
+      const entt::entity e = agents.data()[i];
+      if (!transforms.contains(e))
+        continue;
+      const TransformComponent& t_c = transforms.get(e);
+      FlowAgentComponent& agent_c = agents.get(e);
+      agent_c.velocity = agent_c.speed * sample_flow_field(field, t_c.pos + 0.5f * t_c.size);
+    }
+  });
+};
+
+void
+apply_flow_agent_velocities(Registry& r)
+{
+  const auto view = r.view<const FlowAgentComponent, const PhysicsBodyComponent>(entt::exclude<PhysicsInactiveComponent>);
+  for (const auto& [e, agent_c, pb_c] : view.each())
+    b2Body_SetLinearVelocity(pb_c.id, pixels_to_meters(agent_c.velocity));
+};
+
+} // namespace game2d
@@ -0,0 +1,25 @@
+#pragma once
+
+#include "core/registry.hpp"
+#include "core/scheduler/scheduler.hpp"
+#include "flow_field_components.hpp"
+
+namespace game2d {
+
+// sizes the field and connects the signals that mark obstacles dirty
+void
+init_flow_field_system(Registry& r, FlowFieldState& state, const int width, const int height, const int cell_size);
+
+// follows the receiver, and re-walls the tiles when obstacles change
+void
+update_flow_field_system(SystemContext& ctx, FlowFieldState& state);
+
+// each agent samples its tile. split over the job system.
+void
+update_flow_agents_system(SystemContext& ctx, const FlowField& field);
+
+// box2d calls, so only between physics steps
+void
+apply_flow_agent_velocities(Registry& r);
+
+} // namespace game2d
@@ -0,0 +1,17 @@
+#pragma once
+
+#include "core/particles/particles.hpp"
+
+namespace game2d {
+
+// Emits particles from the centre of the entity's TransformComponent.
+// Only the emitter lives in the registry, the particles do not.
+struct ParticleEmitterComponent
+{
+  ParticleDesc desc;
+  float particles_per_second = 100.0f;
+  float accumulator = 0.0f;
+  bool enabled = true;
+};
+
+} // namespace game2d
@@ -0,0 +1,29 @@
+#include "core/pch.hpp"
+
+#include "particles_system.hpp"
+
+#include "particles_components.hpp"
+
+namespace game2d {
+
+void
+update_particles_system(Registry& r, ParticleBuffer& particles, RandomState& rnd, const float dt)
+{
+  // emitters
+  const auto view = r.view<ParticleEmitterComponent, const TransformComponent>();
+  for (const auto& [e, emitter_c, t_c] : view.each()) {
+    if (!emitter_c.enabled)
+      continue;
+
+    emitter_c.accumulator += emitter_c.particles_per_second * dt;
+    const auto n = (uint32_t)emitter_c.accumulator;
+    emitter_c.accumulator -= (float)n;
+
+    const vec2 center = t_c.pos + 0.5f * t_c.size;
+    emit_particles(particles, rnd, center, emitter_c.desc, n);
+  }
+
+  update_particles(particles, dt);
+}
+
+} // namespace game2d
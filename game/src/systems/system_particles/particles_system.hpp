@@ -0,0 +1,11 @@
+#pragma once
+
+#include "core/common.hpp"
+#include "core/particles/particles.hpp"
+
+namespace game2d {
+
+void
+update_particles_system(Registry& r, ParticleBuffer& particles, RandomState& rnd, const float dt);
+
+} // namespace game2d
@@ -0,0 +1,41 @@
+#pragma once
+
+#include "core/maths/vec.hpp"
+
+#include <cstddef>
+#include <vector>
+
+namespace game2d {
+
+// bodies near an entity with this are kept simulated, as well as the camera
+struct PointOfInterestComponent
+{
+  bool placeholder = true;
+};
+
+// added to a body while b2Body_Disable()d
+struct PhysicsInactiveComponent
+{
+  bool placeholder = true;
+};
+
+// Bodies are disabled when further than outer_radius from every point of interest,
+// and enabled again when within inner_radius of any. The gap stops bodies
+// on the edge from toggling every frame.
+struct PhysicsActivity
+{
+  float inner_radius = 1000.0f; // pixels
+  float outer_radius = 1400.0f; // pixels
+
+  // bodies checked per update. the check resumes from cursor next update.
+  size_t checks_per_update = 4096;
+  size_t cursor = 0;
+
+  // scratch, kept between calls
+  std::vector<vec2> points;
+
+  int n_active = 0;
+  int n_inactive = 0;
+};
+
+} // namespace game2d
@@ -0,0 +1,71 @@
+#include "core/pch.hpp"
+
+#include "physics_activity_system.hpp"
+
+#include "core/box2d/box2d_components.hpp"
+#include "core/common.hpp"
+
+#include <cfloat>
+
+namespace game2d {
+
+static float
+nearest_distance2(const std::vector<vec2>& points, const vec2 p)
+{
+  float best = FLT_MAX;
+  for (const vec2& poi : points) {
+    const float dx = poi.x - p.x;
+    const float dy = poi.y - p.y;
+    best = std::min(best, dx * dx + dy * dy);
+  }
+  return best;
+};
+
+void
+update_physics_activity_system(Registry& r, PhysicsActivity& activity, const vec2 camera_center)
+{
+  auto& points = activity.points;
+  points.clear();
+  points.push_back(camera_center);
+  for (const auto& [e, poi_c, t_c] : r.view<const PointOfInterestComponent, const TransformComponent>().each())
+    points.push_back(t_c.pos + 0.5f * t_c.size);
+
+  const float inner2 = activity.inner_radius * activity.inner_radius;
+  const float outer2 = activity.outer_radius * activity.outer_radius;
+
+  const auto& storage = r.storage<PhysicsBodyComponent>();
+  const size_t n_bodies = storage.size();
+  const size_t n_checks = std::min(activity.checks_per_update, n_bodies);
+  if (activity.cursor >= n_bodies)
+    activity.cursor = 0;
+
+  for (size_t i = 0; i < n_checks; i++) {
+    const entt::entity e = storage.data()[activity.cursor];
+    activity.cursor = activity.cursor + 1 < n_bodies ? activity.cursor + 1 : 0;
+
+    const auto* t_c = r.try_get<const TransformComponent>(e);
+    if (t_c == nullptr)
+      continue;
+
+    // static bodies dont cost anything to step
+    const auto& pb_c = storage.get(e);
+    if (b2Body_GetType(pb_c.id) == b2_staticBody)
+      continue;
+
+    const float d2 = nearest_distance2(points, t_c->pos + 0.5f * t_c->size);
+    const bool inactive = r.all_of<PhysicsInactiveComponent>(e);
+
+    if (!inactive && d2 > outer2) {
+      b2Body_Disable(pb_c.id);
+      r.emplace<PhysicsInactiveComponent>(e);
+    } else if (inactive && d2 < inner2) {
+      b2Body_Enable(pb_c.id);
+      r.remove<PhysicsInactiveComponent>(e);
+    }
+  }
+
+  activity.n_inactive = (int)r.storage<PhysicsInactiveComponent>().size();
+  activity.n_active = (int)n_bodies - activity.n_inactive;
+};
+
+} // namespace game2d
@@ -0,0 +1,14 @@
+#pragma once
+
+#include "core/registry.hpp"
+#include "physics_activity_components.hpp"
+
+#include <entt/fwd.hpp>
+
+namespace game2d {
+
+// round-robins over the bodies, disabling or enabling a slice of them each update
+void
+update_physics_activity_system(Registry& r, PhysicsActivity& activity, const vec2 camera_center);
+
+} // namespace game2d
@@ -0,0 +1,25 @@
+#pragma once
+
+#include "core/common.hpp"
+
+#include <unordered_map>
+#include <vector>
+
+namespace game2d {
+
+// Entities with an InventoryComponent, a TransformComponent and a ColourComponent.
+// Entries are only rebuilt when one of those components is
+// constructed, patched or destroyed, and a new snapshot is only
+// published when an entry changed.
+struct UiModelBuilder
+{
+  std::vector<UIEntity> entries;
+  std::unordered_map<entt::entity, uint32_t> index; // entity -> entries
+
+  // marked by registry signals, may contain duplicates
+  std::vector<entt::entity> dirty;
+
+  UiModel published;
+};
+
+} // namespace game2d
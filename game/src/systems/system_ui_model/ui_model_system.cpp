@@ -0,0 +1,95 @@
+#include "core/pch.hpp"
+
+#include "ui_model_system.hpp"
+
+namespace game2d {
+
+static void
+mark_ui_model_dirty(UiModelBuilder& model, Registry& r, const entt::entity e)
+{
+  // signals fire before a component is removed, so
+  // the inventory is still there when it is destroyed.
+  if (r.all_of<InventoryComponent>(e) || model.index.contains(e))
+    model.dirty.push_back(e);
+};
+
+template<typename T>
+static void
+connect_ui_model(Registry& r, UiModelBuilder& model)
+{
+  // entt ignores a listener that is already connected
+  r.on_construct<T>().template connect<&mark_ui_model_dirty>(model);
+  r.on_update<T>().template connect<&mark_ui_model_dirty>(model);
+  r.on_destroy<T>().template connect<&mark_ui_model_dirty>(model);
+};
+
+void
+init_ui_model(Registry& r, UiModelBuilder& model)
+{
+  connect_ui_model<InventoryComponent>(r, model);
+  connect_ui_model<TransformComponent>(r, model);
+  connect_ui_model<ColourComponent>(r, model);
+};
+
+void
+clear_ui_model(UiModelBuilder& model)
+{
+  model.entries.clear();
+  model.index.clear();
+  model.dirty.clear();
+  model.published.entities.reset();
+  model.published.version++;
+};
+
+static void
+remove_entry(UiModelBuilder& model, const entt::entity e)
+{
+  const auto it = model.index.find(e);
+  if (it == model.index.end())
+    return;
+
+  // swap and pop
+  const uint32_t i = it->second;
+  model.index.erase(it);
+  if (i != model.entries.size() - 1) {
+    model.entries[i] = model.entries.back();
+    model.index[model.entries[i].entity] = i;
+  }
+  model.entries.pop_back();
+};
+
+void
+update_ui_model(const Registry& r, UiModelBuilder& model, CommonUiData& ui_data, make_ui_snapshot_func_t make_snapshot)
+{
+  if (!model.dirty.empty()) {
+    std::sort(model.dirty.begin(), model.dirty.end());
+    model.dirty.erase(std::unique(model.dirty.begin(), model.dirty.end()), model.dirty.end());
+
+    for (const entt::entity e : model.dirty) {
+      if (!r.valid(e) || !r.all_of<InventoryComponent, TransformComponent, ColourComponent>(e)) {
+        remove_entry(model, e);
+        continue;
+      }
+
+      const auto& [inv_c, t_c, col_c] = r.get<const InventoryComponent, const TransformComponent, const ColourComponent>(e);
+      const UIEntity entry{ .entity = e, .renderable = { .transform = t_c, .colour = col_c }, .inventory = inv_c };
+
+      const auto [it, inserted] = model.index.try_emplace(e, (uint32_t)model.entries.size());
+      if (inserted)
+        model.entries.push_back(entry);
+      else
+        model.entries[it->second] = entry;
+    }
+    model.dirty.clear();
+
+    // one copy per change, instead of one per frame per thread
+    model.published.entities = make_snapshot(model.entries);
+    model.published.version++;
+  }
+
+  // ui_data is overwritten with the uithread's copy every frame,
+  // so always hand back the latest snapshot.
+  ui_data.ui_model = model.published;
+};
+
+} // namespace game2d
@@ -0,0 +1,21 @@
+#pragma once
+
+#include "ui_model_components.hpp"
+
+namespace game2d {
+
+// connects the signals that mark entries dirty.
+// components must be changed through emplace/patch/replace/erase to be seen.
+void
+init_ui_model(Registry& r, UiModelBuilder& model);
+
+// forgets every entry, e.g. when the registry is cleared
+void
+clear_ui_model(UiModelBuilder& model);
+
+// applies the dirty entries and publishes a new snapshot if anything changed.
+// make_snapshot comes from the engine, see GameData::make_ui_snapshot
+void
+update_ui_model(const Registry& r, UiModelBuilder& model, CommonUiData& ui_data, make_ui_snapshot_func_t make_snapshot);
+
+} // namespace game2d
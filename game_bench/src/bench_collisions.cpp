@@ -0,0 +1,59 @@
+#include "core/pch.hpp"
+
+#include "core/box2d/box2d_collisions.hpp"
+#include "core/box2d/box2d_components.hpp"
+#include "core/box2d/box2d_helpers.hpp"
+#include "core/common.hpp"
+#include "core/spawn/spawn_helpers.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <vector>
+
+namespace game2d {
+
+// pairs of boxes, moved together and apart every step,
+// so each step produces a begin or end touch per pair.
+static void
+BM_gather_collision_events(benchmark::State& state)
+{
+  const int n = (int)state.range(0);
+
+  Registry r;
+  b2WorldDef world_def = b2DefaultWorldDef();
+  world_def.gravity = { 0.0f, 0.0f };
+  const b2WorldId world_id = b2CreateWorld(&world_def);
+
+  std::vector<b2BodyId> movers(n);
+  std::vector<vec2> anchors(n);
+  for (int i = 0; i < n; i++) {
+    anchors[i] = { 200.0f * (i % 500), 200.0f * (i / 500) };
+    spawn(r, world_id, anchors[i], { 50, 50 }, { 1.0f, 1.0f, 1.0f });
+    const entt::entity e = spawn(r, world_id, anchors[i] + vec2{ 100, 0 }, { 50, 50 }, { 1.0f, 1.0f, 1.0f });
+    movers[i] = r.get<PhysicsBodyComponent>(e).id;
+  }
+
+  CollisionEvents events;
+  bool touching = false;
+
+  for (auto _ : state) {
+    state.PauseTiming();
+    touching = !touching;
+    const vec2 offset = touching ? vec2{ 40, 0 } : vec2{ 100, 0 };
+    for (int i = 0; i < n; i++)
+      b2Body_SetTransform(movers[i], pixels_to_meters(anchors[i] + offset), b2Rot_identity);
+    b2World_Step(world_id, 1.0f / 60.0f, 4);
+    state.ResumeTiming();
+
+    gather_collision_events(world_id, events);
+    benchmark::DoNotOptimize(events.enter.data());
+    benchmark::DoNotOptimize(events.exit.data());
+  }
+
+  state.SetItemsProcessed(state.iterations() * n);
+  b2DestroyWorld(world_id);
+}
+
+BENCHMARK(BM_gather_collision_events)->ArgName("pairs")->Arg(100)->Arg(1000)->Arg(10000);
+
+} // namespace game2d
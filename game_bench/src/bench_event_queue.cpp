@@ -0,0 +1,70 @@
+#include "core/pch.hpp"
+
+#include "core/common.hpp"
+#include "threadsafe_queue.hpp"
+
+#include <benchmark/benchmark.h>
+
+namespace game2d {
+
+static std::vector<SDL_Event>
+make_key_events(const int n)
+{
+  std::vector<SDL_Event> evts(n);
+  for (int i = 0; i < n; i++) {
+    SDL_Event& evt = evts[i];
+    evt = {};
+    evt.type = (i % 2) ? SDL_EVENT_KEY_UP : SDL_EVENT_KEY_DOWN;
+    evt.key.scancode = SDL_SCANCODE_W;
+    evt.key.down = (i % 2) == 0;
+  }
+  return evts;
+}
+
+// a mainthread poll batch in, and the gamethread taking it out
+static void
+BM_event_queue_round_trip(benchmark::State& state)
+{
+  const int n = (int)state.range(0);
+  const std::vector<SDL_Event> batch = make_key_events(n);
+  std::vector<SDL_Event> out;
+  EventQueue<SDL_Event> queue;
+
+  for (auto _ : state) {
+    queue.enqueue(batch, 1);
+    uint64_t stamp_ns = 0;
+    queue.dequeue_all(out, &stamp_ns);
+    benchmark::DoNotOptimize(out.data());
+  }
+
+  state.SetItemsProcessed(state.iterations() * n);
+}
+
+// thread 0 is the gamethread, the others produce, so the lock is contended
+static void
+BM_event_queue_contended(benchmark::State& state)
+{
+  static EventQueue<SDL_Event> queue;
+  const int n = (int)state.range(0);
+  const std::vector<SDL_Event> batch = make_key_events(n);
+  std::vector<SDL_Event> out;
+
+  uint64_t n_dequeued = 0;
+  for (auto _ : state) {
+    if (state.thread_index() == 0) {
+      queue.dequeue_all(out);
+      n_dequeued += out.size();
+    } else
+      queue.enqueue(batch);
+  }
+
+  if (state.thread_index() == 0) {
+    queue.dequeue_all(out); // dont leave anything for the next run
+    state.SetItemsProcessed((int64_t)n_dequeued);
+  }
+}
+
+BENCHMARK(BM_event_queue_round_trip)->ArgName("events")->Arg(1)->Arg(16)->Arg(256);
+BENCHMARK(BM_event_queue_contended)->ArgName("events")->Arg(16)->Threads(2)->Threads(4)->UseRealTime();
+
+} // namespace game2d
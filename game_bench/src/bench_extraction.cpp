@@ -0,0 +1,72 @@
+#include "core/pch.hpp"
+
+#include "core/common.hpp"
+#include "core/render/renderables.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <numeric>
+#include <random>
+
+namespace game2d {
+
+// n renderables. colours are added in a shuffled order,
+// so the two pools are not in the same order, as in a real game.
+static void
+create_renderables(Registry& r, const int n)
+{
+  std::vector<entt::entity> entities(n);
+  r.create(entities.begin(), entities.end());
+  for (int i = 0; i < n; i++)
+    r.emplace<TransformComponent>(entities[i], TransformComponent{ .pos = { (float)i, (float)i }, .size = { 1, 1 } });
+
+  std::minstd_rand rng(0);
+  std::shuffle(entities.begin(), entities.end(), rng);
+  for (const entt::entity e : entities)
+    r.emplace<ColourComponent>(e, ColourComponent{ .r = 1.0f, .g = 0.5f, .b = 0.25f });
+}
+
+// what extraction did before the owning group
+static void
+BM_extract_view(benchmark::State& state)
+{
+  const int n = (int)state.range(0);
+  Registry r;
+  create_renderables(r, n);
+  std::vector<Renderable> out;
+
+  for (auto _ : state) {
+    out.clear();
+    const auto view = r.view<const TransformComponent, const ColourComponent>();
+    view.each([&](entt::entity e, const auto& t_c, const auto& col_c) {
+      out.push_back(Renderable{ .transform = t_c, .colour = col_c });
+    });
+    benchmark::DoNotOptimize(out.data());
+  }
+
+  state.SetItemsProcessed(state.iterations() * n);
+  state.SetBytesProcessed(state.iterations() * n * (int64_t)sizeof(Renderable));
+}
+
+static void
+BM_extract_group(benchmark::State& state)
+{
+  const int n = (int)state.range(0);
+  Registry r;
+  get_renderables_group(r);
+  create_renderables(r, n);
+  std::vector<Renderable> out;
+
+  for (auto _ : state) {
+    extract_renderables(r, out);
+    benchmark::DoNotOptimize(out.data());
+  }
+
+  state.SetItemsProcessed(state.iterations() * n);
+  state.SetBytesProcessed(state.iterations() * n * (int64_t)sizeof(Renderable));
+}
+
+BENCHMARK(BM_extract_view)->ArgName("entities")->Arg(10000)->Arg(100000)->Arg(1000000)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_extract_group)->ArgName("entities")->Arg(10000)->Arg(100000)->Arg(1000000)->Unit(benchmark::kMicrosecond);
+
+} // namespace game2d
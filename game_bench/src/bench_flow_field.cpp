@@ -0,0 +1,94 @@
+#include "core/pch.hpp"
+
+#include "core/common.hpp"
+#include "core/navigation/flow_field.hpp"
+
+#include <benchmark/benchmark.h>
+
+namespace game2d {
+
+// A square field with the goal in one corner, and a wall down
+// the middle with a gap at the bottom, so paths have to bend.
+static void
+make_field(FlowField& field, const int size)
+{
+  init_flow_field(field, size, size, 16, { 0, 0 });
+  const int goal = 0;
+  set_flow_goals(field, { &goal, 1 });
+  for (int y = 0; y < size - 2; y++)
+    field.costs[grid_position_to_index({ size / 2, y }, size)] = FLOW_COST_WALL;
+};
+
+static void
+BM_flow_field_rebuild(benchmark::State& state)
+{
+  Registry r;
+  SystemContext ctx{ .r = r };
+  FlowField field;
+  const int size = (int)state.range(0);
+  make_field(field, size);
+
+  for (auto _ : state) {
+    field.dirty = true;
+    update_flow_field(field, ctx);
+  }
+
+  state.SetItemsProcessed(state.iterations() * size * size);
+}
+
+// opens and closes one tile in the wall each iteration
+static void
+BM_flow_field_incremental(benchmark::State& state)
+{
+  Registry r;
+  SystemContext ctx{ .r = r };
+  FlowField field;
+  const int size = (int)state.range(0);
+  make_field(field, size);
+  update_flow_field(field, ctx);
+
+  const int tile = grid_position_to_index({ size / 2, size / 4 }, size);
+  bool open = false;
+  uint64_t touched = 0;
+  for (auto _ : state) {
+    open = !open;
+    set_flow_cost(field, tile, open ? FLOW_COST_OPEN : FLOW_COST_WALL);
+    update_flow_field(field, ctx);
+    touched += field.last_touched;
+  }
+
+  state.counters["touched"] = benchmark::Counter((double)touched, benchmark::Counter::kAvgIterations);
+}
+
+// what each agent pays per tick
+static void
+BM_flow_field_sample(benchmark::State& state)
+{
+  Registry r;
+  SystemContext ctx{ .r = r };
+  FlowField field;
+  const int size = 256;
+  make_field(field, size);
+  update_flow_field(field, ctx);
+
+  const size_t n = (size_t)state.range(0);
+  std::vector<vec2> positions(n);
+  RandomState rnd(0);
+  for (vec2& p : positions)
+    p = { random(rnd, 0.0f, (float)(size * field.cell_size)), random(rnd, 0.0f, (float)(size * field.cell_size)) };
+  std::vector<vec2> velocities(n);
+
+  for (auto _ : state) {
+    for (size_t i = 0; i < n; i++)
+      velocities[i] = 100.0f * sample_flow_field(field, positions[i]);
+    benchmark::DoNotOptimize(velocities.data());
+  }
+
+  state.SetItemsProcessed(state.iterations() * n);
+}
+
+BENCHMARK(BM_flow_field_rebuild)->ArgName("size")->Arg(64)->Arg(256)->Arg(512)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_flow_field_incremental)->ArgName("size")->Arg(64)->Arg(256)->Arg(512)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_flow_field_sample)->ArgName("agents")->Arg(1000)->Arg(10000)->Unit(benchmark::kMicrosecond);
+
+} // namespace game2d
@@ -0,0 +1,138 @@
+#include "core/pch.hpp"
+
+#include "core/log/log.hpp"
+
+#include <benchmark/benchmark.h>
+
+namespace game2d {
+
+// the cost on the calling thread is the point, not the terminal's.
+// both paths still format, the sink just drops the line
+static void
+null_log_output(void*, int, SDL_LogPriority, const char*) {};
+
+struct NullLogOutput
+{
+  NullLogOutput() { SDL_SetLogOutputFunction(null_log_output, nullptr); }
+  ~NullLogOutput() { SDL_SetLogOutputFunction(SDL_GetDefaultLogOutputFunction(), nullptr); }
+};
+
+// the benchmark functions run more than once, the logger is set up once
+static Logger&
+get_bench_logger()
+{
+  static Logger logger;
+  static const bool initialized = (init_logger(logger), true);
+  (void)initialized;
+  return logger;
+};
+
+// what a contact handler did before: format and write on the calling thread
+static void
+BM_logger_sdl_log(benchmark::State& state)
+{
+  NullLogOutput sink;
+  uint32_t i = 0;
+  for (auto _ : state) {
+    SDL_Log("collision enter. s_eid: %i par_eid: %i, s_eid: %i, par_eid: %i ", i, i + 1, i + 2, i + 3);
+    i++;
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+static void
+BM_logger_async(benchmark::State& state)
+{
+  NullLogOutput sink;
+  Logger& logger = get_bench_logger();
+  set_logger(&logger);
+  start_logger(logger);
+
+  const auto count_dropped = [&logger]() {
+    uint64_t n = 0;
+    for (const LogRing& ring : logger.rings)
+      n += ring.n_dropped.load();
+    return n;
+  };
+  const uint64_t dropped_before = count_dropped();
+
+  uint32_t i = 0;
+  for (auto _ : state) {
+    LOG(INFO, COLLISION, "collision enter. s_eid: %i par_eid: %i, s_eid: %i, par_eid: %i ", i, i + 1, i + 2, i + 3);
+    i++;
+  }
+
+  // a tight loop outruns the log thread. dropped records cost less than written ones
+  const double n_dropped = (double)(count_dropped() - dropped_before);
+  state.counters["dropped"] = benchmark::Counter(n_dropped / (double)state.iterations());
+
+  stop_logger(logger);
+  set_logger(nullptr);
+  state.SetItemsProcessed(state.iterations());
+}
+
+// the log thread keeps up: the ring is flushed outside the timing
+// before it fills, so every record is written in to it
+static void
+BM_logger_async_flushed(benchmark::State& state)
+{
+  NullLogOutput sink;
+  Logger& logger = get_bench_logger();
+  set_logger(&logger);
+  start_logger(logger);
+
+  uint32_t i = 0;
+  for (auto _ : state) {
+    LOG(INFO, COLLISION, "collision enter. s_eid: %i par_eid: %i, s_eid: %i, par_eid: %i ", i, i + 1, i + 2, i + 3);
+    if (++i % 256 == 0) {
+      state.PauseTiming();
+      flush_logger(logger);
+      state.ResumeTiming();
+    }
+  }
+
+  stop_logger(logger);
+  set_logger(nullptr);
+  state.SetItemsProcessed(state.iterations());
+}
+
+// with a string, which is copied in to the record
+static void
+BM_logger_async_string(benchmark::State& state)
+{
+  NullLogOutput sink;
+  Logger& logger = get_bench_logger();
+  set_logger(&logger);
+  start_logger(logger);
+
+  const char* name = "container_receiver";
+  uint32_t i = 0;
+  for (auto _ : state) {
+    LOG(INFO, GAMEPLAY, "%s has: %i items", name, i);
+    i++;
+  }
+
+  stop_logger(logger);
+  set_logger(nullptr);
+  state.SetItemsProcessed(state.iterations());
+}
+
+// below GAME2D_LOG_MIN_LEVEL, so nothing is emitted
+static void
+BM_logger_compiled_out(benchmark::State& state)
+{
+  uint32_t i = 0;
+  for (auto _ : state) {
+    LOG(TRACE, COLLISION, "collision exit. %i", i);
+    benchmark::DoNotOptimize(i++);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_logger_sdl_log);
+BENCHMARK(BM_logger_async);
+BENCHMARK(BM_logger_async_flushed);
+BENCHMARK(BM_logger_async_string);
+BENCHMARK(BM_logger_compiled_out);
+
+} // namespace game2d
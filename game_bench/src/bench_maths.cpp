@@ -0,0 +1,75 @@
+#include "core/pch.hpp"
+
+#include "core/maths/mat.hpp"
+#include "core/maths/vec.hpp"
+
+#include <benchmark/benchmark.h>
+
+namespace game2d {
+
+// what the camera and particles do per element
+static void
+BM_vec2_integrate(benchmark::State& state)
+{
+  const int n = (int)state.range(0);
+  std::vector<vec2> pos(n, vec2{ 0.0f, 0.0f });
+  std::vector<vec2> vel(n);
+  for (int i = 0; i < n; i++)
+    vel[i] = { (float)(i % 7), (float)(i % 13) };
+  const float dt = 1.0f / 60.0f;
+
+  for (auto _ : state) {
+    for (int i = 0; i < n; i++)
+      pos[i] = pos[i] + dt * vel[i];
+    benchmark::DoNotOptimize(pos.data());
+    benchmark::ClobberMemory();
+  }
+
+  state.SetItemsProcessed(state.iterations() * n);
+}
+
+static void
+BM_vec2_arithmetic(benchmark::State& state)
+{
+  vec2 a{ 1.0f, 2.0f };
+  const vec2 b{ 0.5f, 0.25f };
+
+  for (auto _ : state) {
+    a = (a + b) * b - (a / vec2{ 2.0f, 2.0f });
+    benchmark::DoNotOptimize(a);
+  }
+}
+
+static void
+BM_matrix_multiply(benchmark::State& state)
+{
+  const Matrix4x4 proj = Matrix4x4_CreateOrthographicOffCenter(0, 1280, 720, 0, 0, -1);
+  Matrix4x4 view = Matrix4x4_CreateView({ 10.0f, 20.0f });
+
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(view);
+    const Matrix4x4 view_projection = view * proj;
+    benchmark::DoNotOptimize(view_projection);
+  }
+}
+
+// the renderthread's once a frame camera
+static void
+BM_matrix_view_projection(benchmark::State& state)
+{
+  vec2 camera_pos{ 0.0f, 0.0f };
+
+  for (auto _ : state) {
+    camera_pos.x += 1.0f;
+    const Matrix4x4 proj = Matrix4x4_CreateOrthographicOffCenter(0, 1280, 720, 0, 0, -1);
+    const Matrix4x4 view_projection = Matrix4x4_CreateView(camera_pos) * proj;
+    benchmark::DoNotOptimize(view_projection);
+  }
+}
+
+BENCHMARK(BM_vec2_integrate)->ArgName("n")->Arg(1000)->Arg(100000)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_vec2_arithmetic);
+BENCHMARK(BM_matrix_multiply);
+BENCHMARK(BM_matrix_view_projection);
+
+} // namespace game2d
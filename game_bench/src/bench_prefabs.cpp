@@ -0,0 +1,106 @@
+#include "core/pch.hpp"
+
+#include "core/common.hpp"
+#include "core/inventory/inventory_pool.hpp"
+#include "core/prefabs/prefabs.hpp"
+#include "core/spawn/spawn_helpers.hpp"
+#include "systems/system_items/items_components.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <optional>
+
+namespace game2d {
+
+constexpr std::string_view enemy_json = R"({
+  "prefabs": [
+    {
+      "name": "enemy",
+      "size": [20, 20],
+      "body": { "static": false, "sensor": false },
+      "components": { "colour": [1.0, 0.5, 0.0, 1.0], "container_provider": {}, "inventory": { "capacity": 4, "items": 1 } }
+    }
+  ]
+})";
+
+static b2WorldId
+create_prefab_world()
+{
+  b2WorldDef world_def = b2DefaultWorldDef();
+  world_def.gravity = { 0.0f, 0.0f };
+  return b2CreateWorld(&world_def);
+}
+
+static vec2
+wave_position(const int i)
+{
+  return { 25.0f * (i % 200), 25.0f * (i / 200) };
+}
+
+// what game_init did before prefabs
+static void
+BM_spawn_wave_composed(benchmark::State& state)
+{
+  const int n = (int)state.range(0);
+  std::optional<Registry> r;
+
+  for (auto _ : state) {
+    state.PauseTiming();
+    r.emplace();
+    const b2WorldId world_id = create_prefab_world();
+    state.ResumeTiming();
+
+    for (int i = 0; i < n; i++) {
+      const auto e = spawn(*r, world_id, wave_position(i), { 20, 20 }, { 1.0f, 0.5f, 0.0f });
+      r->emplace<ContainerProviderComponent>(e);
+      create_inventories(*r, { &e, 1 }, 4, 1);
+    }
+
+    state.PauseTiming();
+    b2DestroyWorld(world_id);
+    r.reset();
+    state.ResumeTiming();
+  }
+
+  state.SetItemsProcessed(state.iterations() * n);
+}
+
+static void
+BM_spawn_wave_prefab(benchmark::State& state)
+{
+  const int n = (int)state.range(0);
+
+  // parsed once, outside the timed loop
+  PrefabLibrary library;
+  parse_prefabs(library, enemy_json);
+  const Prefab& enemy = get_prefab(library, "enemy");
+
+  std::vector<vec2> positions(n);
+  for (int i = 0; i < n; i++)
+    positions[i] = wave_position(i);
+  std::vector<entt::entity> out(n);
+
+  std::optional<Registry> r;
+
+  for (auto _ : state) {
+    state.PauseTiming();
+    r.emplace();
+    const b2WorldId world_id = create_prefab_world();
+    state.ResumeTiming();
+
+    spawn_prefab_batch(*r, world_id, enemy, positions, out);
+    benchmark::DoNotOptimize(out.data());
+
+    state.PauseTiming();
+    b2DestroyWorld(world_id);
+    r.reset();
+    state.ResumeTiming();
+  }
+
+  state.SetItemsProcessed(state.iterations() * n);
+}
+
+BENCHMARK(BM_spawn_wave_composed)->ArgName("enemies")->Arg(5000)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_spawn_wave_prefab)->ArgName("enemies")->Arg(5000)->Unit(benchmark::kMillisecond);
+
+} // namespace game2d
@@ -0,0 +1,78 @@
+#include "core/pch.hpp"
+
+#include "core/common.hpp"
+#include "core/render/renderables.hpp"
+
+#include <benchmark/benchmark.h>
+
+namespace game2d {
+
+static std::vector<Renderable>
+make_renderables(const int n)
+{
+  std::vector<Renderable> renderables(n);
+  for (int i = 0; i < n; i++) {
+    renderables[i].transform = TransformComponent{ .pos = { (float)i, (float)i }, .size = { 8, 8 }, .rotation_radians = 0.1f };
+    renderables[i].colour = ColourComponent{ .r = 1.0f, .g = 0.5f, .b = 0.25f };
+  }
+  return renderables;
+}
+
+// what the renderthread writes in to the mapped transfer buffer each frame
+static void
+BM_pack_sprite_instances(benchmark::State& state)
+{
+  const int n = (int)state.range(0);
+  const std::vector<Renderable> renderables = make_renderables(n);
+  std::vector<SpriteInstance> instances(n);
+
+  for (auto _ : state) {
+    pack_sprite_instances(renderables, instances.data());
+    benchmark::DoNotOptimize(instances.data());
+    benchmark::ClobberMemory();
+  }
+
+  state.SetItemsProcessed(state.iterations() * n);
+  state.SetBytesProcessed(state.iterations() * n * (int64_t)sizeof(SpriteInstance));
+}
+
+// one frame through the double buffer, as the engine does it:
+// the gamethread writes the back buffer and swaps, the renderthread copies the front one out
+static void
+BM_render_data_handoff(benchmark::State& state)
+{
+  const int n = (int)state.range(0);
+  const std::vector<Renderable> renderables = make_renderables(n);
+  std::vector<SpriteInstance> particles(n / 4);
+
+  static RenderData buffers[2];
+  int read_buffer = 0;
+  GameUIData ui_data;
+  std::vector<SpriteInstance> instances(n + n / 4); // stands in for the mapped transfer buffer
+
+  for (auto _ : state) {
+    {
+      RenderData& wb = buffers[1 - read_buffer];
+      std::scoped_lock<std::mutex> lock(wb.mtx);
+      wb.renderable = renderables;
+      wb.particles = particles;
+      wb.camera_pos = { 1.0f, 2.0f };
+    }
+    read_buffer = 1 - read_buffer;
+    {
+      RenderData& rb = buffers[read_buffer];
+      std::scoped_lock<std::mutex> lock(rb.mtx);
+      copy_render_data(rb, ui_data);
+      copy_particle_instances(rb, instances.data() + n, (uint32_t)(instances.size() - n));
+    }
+    benchmark::DoNotOptimize(ui_data.renderable.data());
+    benchmark::DoNotOptimize(instances.data());
+  }
+
+  state.SetItemsProcessed(state.iterations() * n);
+}
+
+BENCHMARK(BM_pack_sprite_instances)->ArgName("sprites")->Arg(1000)->Arg(10000)->Arg(100000)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_render_data_handoff)->ArgName("renderables")->Arg(1000)->Arg(10000)->Arg(100000)->Unit(benchmark::kMicrosecond);
+
+} // namespace game2d
@@ -0,0 +1,86 @@
+#include "core/pch.hpp"
+
+#include "core/common.hpp"
+#include "core/spawn/spawn_helpers.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <optional>
+
+namespace game2d {
+
+static b2WorldId
+create_spawn_world()
+{
+  b2WorldDef world_def = b2DefaultWorldDef();
+  world_def.gravity = { 0.0f, 0.0f };
+  return b2CreateWorld(&world_def);
+}
+
+static vec2
+spawn_position(const int i)
+{
+  return { 100.0f * (i % 1000), 100.0f * (i / 1000) };
+}
+
+static void
+BM_spawn_single(benchmark::State& state)
+{
+  const int n = (int)state.range(0);
+
+  std::optional<Registry> r;
+
+  for (auto _ : state) {
+    state.PauseTiming();
+    r.emplace();
+    const b2WorldId world_id = create_spawn_world();
+    state.ResumeTiming();
+
+    for (int i = 0; i < n; i++)
+      benchmark::DoNotOptimize(spawn(*r, world_id, spawn_position(i), { 50, 50 }, { 1.0f, 1.0f, 1.0f }));
+
+    state.PauseTiming();
+    b2DestroyWorld(world_id);
+    r.reset();
+    state.ResumeTiming();
+  }
+
+  state.SetItemsProcessed(state.iterations() * n);
+}
+
+static void
+BM_spawn_batch(benchmark::State& state)
+{
+  const int n = (int)state.range(0);
+
+  std::vector<vec2> positions(n);
+  for (int i = 0; i < n; i++)
+    positions[i] = spawn_position(i);
+  const std::vector<vec2> sizes(n, vec2{ 50, 50 });
+  const std::vector<ColourComponent> colours(n, ColourComponent{ 1.0f, 1.0f, 1.0f });
+  std::vector<entt::entity> out(n);
+
+  std::optional<Registry> r;
+
+  for (auto _ : state) {
+    state.PauseTiming();
+    r.emplace();
+    const b2WorldId world_id = create_spawn_world();
+    state.ResumeTiming();
+
+    spawn_batch(*r, world_id, positions, sizes, colours, out);
+    benchmark::DoNotOptimize(out.data());
+
+    state.PauseTiming();
+    b2DestroyWorld(world_id);
+    r.reset();
+    state.ResumeTiming();
+  }
+
+  state.SetItemsProcessed(state.iterations() * n);
+}
+
+BENCHMARK(BM_spawn_single)->ArgName("bodies")->Arg(1000)->Arg(10000)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_spawn_batch)->ArgName("bodies")->Arg(1000)->Arg(10000)->Unit(benchmark::kMillisecond);
+
+} // namespace game2d
@@ -0,0 +1,87 @@
+#include "core/pch.hpp"
+
+#include "core/box2d/box2d_components.hpp"
+#include "core/box2d/box2d_helpers.hpp"
+#include "core/common.hpp"
+#include "render_helpers.hpp"
+
+#include <benchmark/benchmark.h>
+
+namespace game2d {
+
+// A grid of bodies far enough apart to never touch.
+// moving_percent of them are dynamic with a velocity, the rest are static.
+struct TransformsWorld
+{
+  Registry r;
+  b2WorldId world_id = B2_ZERO_INIT;
+
+  TransformsWorld(const int n_bodies, const int moving_percent)
+  {
+    b2WorldDef world_def = b2DefaultWorldDef();
+    world_def.gravity = { 0.0f, 0.0f };
+    world_def.enableSleep = true;
+    world_id = b2CreateWorld(&world_def);
+
+    const int columns = 1000;
+    const b2Polygon box = b2MakeBox(0.5f, 0.5f);
+    for (int i = 0; i < n_bodies; i++) {
+      const bool moving = (i % 100) < moving_percent;
+
+      b2BodyDef body_def = b2DefaultBodyDef();
+      body_def.type = moving ? b2_dynamicBody : b2_staticBody;
+      body_def.position = { 2.0f * (i % columns), 2.0f * (i / columns) };
+      body_def.linearVelocity = moving ? b2Vec2{ 1.0f, 0.0f } : b2Vec2{ 0.0f, 0.0f };
+      body_def.fixedRotation = true;
+      const b2BodyId body_id = b2CreateBody(world_id, &body_def);
+
+      const b2ShapeDef shape_def = b2DefaultShapeDef();
+      b2CreatePolygonShape(body_id, &shape_def, &box);
+
+      const auto e = r.create();
+      r.emplace<TransformComponent>(e, TransformComponent{ .size = meters_to_pixels(b2Vec2{ 1.0f, 1.0f }) });
+      r.emplace<PhysicsBodyComponent>(e, make_physics_body_component(body_id));
+      set_entity_from_body_id(body_id, e);
+    }
+
+    // generate move events
+    b2World_Step(world_id, 1.0f / 60.0f, 4);
+  }
+
+  ~TransformsWorld() { b2DestroyWorld(world_id); }
+};
+
+static void
+BM_transforms_full_sync(benchmark::State& state)
+{
+  TransformsWorld world((int)state.range(0), (int)state.range(1));
+
+  for (auto _ : state)
+    update_transforms_from_physics(world.r);
+
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void
+BM_transforms_body_events(benchmark::State& state)
+{
+  TransformsWorld world((int)state.range(0), (int)state.range(1));
+  state.counters["move_events"] = (double)b2World_GetBodyEvents(world.world_id).moveCount;
+
+  for (auto _ : state)
+    update_transforms_from_body_events(world.r, world.world_id);
+
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// args: total bodies, percentage of bodies moving
+BENCHMARK(BM_transforms_full_sync)
+  ->ArgNames({ "bodies", "moving%" })
+  ->ArgsProduct({ { 10000, 100000 }, { 0, 1, 10, 50, 100 } })
+  ->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_transforms_body_events)
+  ->ArgNames({ "bodies", "moving%" })
+  ->ArgsProduct({ { 10000, 100000 }, { 0, 1, 10, 50, 100 } })
+  ->Unit(benchmark::kMicrosecond);
+
+} // namespace game2d
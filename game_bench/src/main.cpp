@@ -0,0 +1,20 @@
+#include <benchmark/benchmark.h>
+
+// Run with e.g.
+// game_bench --benchmark_filter=transforms
+// game_bench --benchmark_out=results.json --benchmark_out_format=json
+//
+// Runs headless, nothing opens a window or initialises SDL video.
+// The bench_json target saves a run per commit, see cmake/run_bench.cmake.
+
+int
+main(int argc, char** argv)
+{
+  benchmark::Initialize(&argc, argv);
+  if (benchmark::ReportUnrecognizedArguments(argc, argv))
+    return 1;
+
+  benchmark::RunSpecifiedBenchmarks();
+  benchmark::Shutdown();
+  return 0;
+}
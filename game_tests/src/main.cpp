@@ -1,9 +1,7 @@
+#include "core/pch.hpp"
 
-#include "engine/maths/grid.hpp"
-#include <SDL2/SDL.h>
+#include "core/maths/grid.hpp"
 
-#include <fmt/core.h>
-#include <glm/glm.hpp>
 #include <gtest/gtest.h>
 
 // Logical	    ASSERT_TRUE(condition)
@@ -20,10 +18,12 @@
 //                      ASSERT_ANY_THROW(statement)
 //                      ASSERT_NO_THROW(statement)
 
+using namespace game2d;
+
 int
 main(int argc, char** argv)
 {
-  fmt::println("Running main() from {}", __FILE__);
+  SDL_Log("Running main() from %s", __FILE__);
 
   testing::InitGoogleTest(&argc, argv);
 
@@ -36,11 +36,28 @@ TEST(TestSuite, HelloMaths)
 {
   // arrange
   const int index = 0;
-  const glm::ivec2 gp{ 0, 0 };
+  const ivec2 gp{ 0, 0 };
 
   // act
-  const glm::ivec2 result = engine::grid::index_to_grid_position(index, 5, 5);
+  const ivec2 result = index_to_grid_position(index, 5);
 
   // assert
   ASSERT_EQ(gp, result);
 };
+
+TEST(Grid, IndexRoundTrip)
+{
+  const int width = 7;
+  for (int i = 0; i < width * 5; i++)
+    ASSERT_EQ(i, grid_position_to_index(index_to_grid_position(i, width), width));
+  ASSERT_EQ((ivec2{ 3, 2 }), index_to_grid_position(17, width));
+};
+
+TEST(Grid, WorldPositions)
+{
+  ASSERT_EQ((ivec2{ 1, 2 }), world_position_to_grid_position({ 47.0f, 64.0f }, 32));
+  ASSERT_EQ((ivec2{ -1, 0 }), world_position_to_grid_position({ -1.0f, 0.0f }, 32));
+  ASSERT_FLOAT_EQ(48.0f, grid_position_to_world_center({ 1, 0 }, 32).x);
+  ASSERT_FALSE(grid_position_in_bounds({ 5, 0 }, 5, 5));
+  ASSERT_TRUE(grid_position_in_bounds({ 4, 4 }, 5, 5));
+};
@@ -0,0 +1,81 @@
+#include "core/pch.hpp"
+
+#include "core/box2d/box2d_categories.hpp"
+
+#include <box2d/box2d.h>
+#include <gtest/gtest.h>
+
+using namespace game2d;
+
+static void
+on_enter_noop(Registry& r, const CollisionPair& pair) {};
+
+static constexpr CollisionHandlerTable
+make_test_handlers()
+{
+  CollisionHandlerTable table{};
+  add_collision_handler(table, CollisionCategory::PLAYER, CollisionCategory::CONTAINER_PROVIDER, &on_enter_noop);
+  return table;
+};
+static constexpr CollisionMasks test_masks = make_collision_masks(make_test_handlers());
+
+// events on, as the spawn defs have them
+static b2ShapeId
+create_box(const b2WorldId world_id, const b2BodyType type, const b2Vec2 pos, const float half, const bool is_sensor)
+{
+  b2BodyDef body_def = b2DefaultBodyDef();
+  body_def.type = type;
+  body_def.position = pos;
+  const b2BodyId body_id = b2CreateBody(world_id, &body_def);
+
+  b2ShapeDef shape_def = b2DefaultShapeDef();
+  shape_def.isSensor = is_sensor;
+  shape_def.enableContactEvents = true;
+  shape_def.enableSensorEvents = true;
+  const b2Polygon box = b2MakeBox(half, half);
+  return b2CreatePolygonShape(body_id, &shape_def, &box);
+};
+
+TEST(CollisionFilters, TaggedBodyStillCollidesWithAWall)
+{
+  const b2WorldDef world_def = b2DefaultWorldDef();
+  const b2WorldId world_id = b2CreateWorld(&world_def);
+
+  const b2ShapeId wall = create_box(world_id, b2_staticBody, { 0.0f, 0.0f }, 1.0f, false);
+  const b2ShapeId player = create_box(world_id, b2_dynamicBody, { 0.0f, 3.0f }, 0.5f, false);
+  apply_collision_filter(wall, CollisionCategory::DEFAULT, test_masks);
+  apply_collision_filter(player, CollisionCategory::PLAYER, test_masks);
+
+  for (int i = 0; i < 120; i++)
+    b2World_Step(world_id, 1.0f / 60.0f, 4);
+
+  // resting on the wall, not fallen through it
+  b2ContactData contact;
+  ASSERT_EQ(1, b2Shape_GetContactData(player, &contact, 1));
+  ASSERT_GT(b2Body_GetPosition(b2Shape_GetBody(player)).y, 1.0f);
+
+  b2DestroyWorld(world_id);
+};
+
+TEST(CollisionFilters, SensorsOnlyReportHandledCategories)
+{
+  b2WorldDef world_def = b2DefaultWorldDef();
+  world_def.gravity = { 0.0f, 0.0f };
+  const b2WorldId world_id = b2CreateWorld(&world_def);
+
+  const b2ShapeId provider = create_box(world_id, b2_staticBody, { 0.0f, 0.0f }, 2.0f, true);
+  const b2ShapeId player = create_box(world_id, b2_dynamicBody, { -1.0f, 0.0f }, 0.25f, false);
+  const b2ShapeId crate = create_box(world_id, b2_dynamicBody, { 1.0f, 0.0f }, 0.25f, false);
+  apply_collision_filter(provider, CollisionCategory::CONTAINER_PROVIDER, test_masks);
+  apply_collision_filter(player, CollisionCategory::PLAYER, test_masks);
+  apply_collision_filter(crate, CollisionCategory::DEFAULT, test_masks);
+
+  b2World_Step(world_id, 1.0f / 60.0f, 4);
+
+  const b2SensorEvents events = b2World_GetSensorEvents(world_id);
+  ASSERT_EQ(1, events.beginCount);
+  ASSERT_TRUE(B2_ID_EQUALS(provider, events.beginEvents[0].sensorShapeId));
+  ASSERT_TRUE(B2_ID_EQUALS(player, events.beginEvents[0].visitorShapeId));
+
+  b2DestroyWorld(world_id);
+};
@@ -0,0 +1,106 @@
+#include "core/pch.hpp"
+
+#include "core/common.hpp"
+#include "core/navigation/flow_field.hpp"
+
+#include <gtest/gtest.h>
+
+using namespace game2d;
+
+TEST(FlowField, OpenGridIsManhattanDistance)
+{
+  Registry r;
+  SystemContext ctx{ .r = r };
+  FlowField field;
+  init_flow_field(field, 8, 6, 10, { 0, 0 });
+  const int goal = grid_position_to_index({ 0, 0 }, 8);
+  set_flow_goals(field, { &goal, 1 });
+  update_flow_field(field, ctx);
+
+  ASSERT_EQ(0u, field.integration[goal]);
+  ASSERT_EQ(7u + 5u, field.integration[grid_position_to_index({ 7, 5 }, 8)]);
+
+  // diagonal, towards the goal
+  const vec2 dir = sample_flow_field(field, { 55.0f, 55.0f });
+  ASSERT_LT(dir.x, 0.0f);
+  ASSERT_LT(dir.y, 0.0f);
+};
+
+TEST(FlowField, WallsAreWalkedAround)
+{
+  Registry r;
+  SystemContext ctx{ .r = r };
+  FlowField field;
+  init_flow_field(field, 5, 5, 10, { 0, 0 });
+  const int goal = grid_position_to_index({ 4, 0 }, 5);
+  set_flow_goals(field, { &goal, 1 });
+
+  // a wall down x = 2, open at the bottom
+  for (int y = 0; y < 4; y++)
+    set_flow_cost(field, grid_position_to_index({ 2, y }, 5), FLOW_COST_WALL);
+  update_flow_field(field, ctx);
+
+  ASSERT_EQ(FLOW_UNREACHABLE, field.integration[grid_position_to_index({ 2, 0 }, 5)]);
+  ASSERT_EQ(6u + 6u, field.integration[grid_position_to_index({ 0, 0 }, 5)]);
+  ASSERT_FLOAT_EQ(0.0f, sample_flow_field(field, { 25.0f, 5.0f }).x);
+};
+
+// incremental updates must end up where a rebuild would
+TEST(FlowField, IncrementalMatchesRebuild)
+{
+  Registry r;
+  SystemContext ctx{ .r = r };
+  const int w = 16;
+  const int h = 12;
+  FlowField incremental;
+  FlowField rebuilt;
+  init_flow_field(incremental, w, h, 10, { 0, 0 });
+  init_flow_field(rebuilt, w, h, 10, { 0, 0 });
+  const int goals[] = { grid_position_to_index({ 3, 3 }, w), grid_position_to_index({ 12, 9 }, w) };
+  set_flow_goals(incremental, goals);
+  set_flow_goals(rebuilt, goals);
+  update_flow_field(incremental, ctx);
+
+  RandomState rnd(1);
+  for (int step = 0; step < 200; step++) {
+    const int index = (int)random(rnd, 0.0f, (float)(w * h));
+    const float roll = random(rnd, 0.0f, 1.0f);
+    const uint8_t cost = roll < 0.3f ? FLOW_COST_WALL : (uint8_t)(1 + (int)(roll * 4.0f));
+    set_flow_cost(incremental, index, cost);
+    set_flow_cost(rebuilt, index, cost);
+
+    update_flow_field(incremental, ctx);
+    rebuilt.dirty = true;
+    update_flow_field(rebuilt, ctx);
+
+    ASSERT_EQ(rebuilt.integration, incremental.integration) << "step " << step;
+    for (int i = 0; i < w * h; i++) {
+      ASSERT_FLOAT_EQ(rebuilt.directions[i].x, incremental.directions[i].x);
+      ASSERT_FLOAT_EQ(rebuilt.directions[i].y, incremental.directions[i].y);
+    }
+  }
+  ASSERT_GT(incremental.n_incremental, 0u);
+};
+
+// an obstacle's far edge is exclusive
+TEST(FlowField, RectEndingOnATileBoundary)
+{
+  FlowField field;
+  init_flow_field(field, 8, 8, 10, { 0, 0 });
+
+  ivec2 min;
+  ivec2 max;
+  ASSERT_TRUE(flow_field_rect_tiles(field, { 10.0f, 20.0f }, { 20.0f, 10.0f }, min, max));
+  ASSERT_EQ((ivec2{ 1, 2 }), min);
+  ASSERT_EQ((ivec2{ 2, 2 }), max);
+
+  // past a boundary covers the next tile
+  ASSERT_TRUE(flow_field_rect_tiles(field, { 10.0f, 20.0f }, { 20.5f, 10.0f }, min, max));
+  ASSERT_EQ((ivec2{ 3, 2 }), max);
+
+  // clamped to the field, and nothing when outside it
+  ASSERT_TRUE(flow_field_rect_tiles(field, { -15.0f, 70.0f }, { 30.0f, 30.0f }, min, max));
+  ASSERT_EQ((ivec2{ 0, 7 }), min);
+  ASSERT_EQ((ivec2{ 1, 7 }), max);
+  ASSERT_FALSE(flow_field_rect_tiles(field, { 80.0f, 0.0f }, { 10.0f, 10.0f }, min, max));
+};
@@ -0,0 +1,100 @@
+#include "core/pch.hpp"
+
+#include "core/input/input.hpp"
+
+#include <gtest/gtest.h>
+
+using namespace game2d;
+
+static SDL_Event
+make_key(const SDL_Scancode scancode, const bool down, const bool repeat = false)
+{
+  SDL_Event evt{};
+  evt.type = down ? SDL_EVENT_KEY_DOWN : SDL_EVENT_KEY_UP;
+  evt.key.scancode = scancode;
+  evt.key.down = down;
+  evt.key.repeat = repeat;
+  return evt;
+};
+
+TEST(Input, KeysMapToActions)
+{
+  static InputState input;
+  init_input(input);
+
+  const SDL_Event down[] = { make_key(SDL_SCANCODE_W, true), make_key(SDL_SCANCODE_W, true, true) };
+  update_input(input, down);
+  ASSERT_TRUE(action_held(input, InputAction::MOVE_UP));
+  ASSERT_TRUE(action_pressed(input, InputAction::MOVE_UP));
+  ASSERT_FALSE(action_held(input, InputAction::MOVE_DOWN));
+
+  // held carries over, pressed does not
+  update_input(input, {});
+  ASSERT_TRUE(action_held(input, InputAction::MOVE_UP));
+  ASSERT_FALSE(action_pressed(input, InputAction::MOVE_UP));
+
+  const SDL_Event up[] = { make_key(SDL_SCANCODE_W, false) };
+  update_input(input, up);
+  ASSERT_FALSE(action_held(input, InputAction::MOVE_UP));
+  ASSERT_TRUE(action_released(input, InputAction::MOVE_UP));
+  shutdown_input(input);
+};
+
+TEST(Input, RebindingReplacesTheDefault)
+{
+  static InputState input;
+  init_input(input);
+  bind_key(input, SDL_SCANCODE_W, InputAction::COUNT);
+  bind_key(input, SDL_SCANCODE_I, InputAction::MOVE_UP);
+
+  const SDL_Event evts[] = { make_key(SDL_SCANCODE_W, true), make_key(SDL_SCANCODE_I, true) };
+  update_input(input, { evts, 1 });
+  ASSERT_FALSE(action_held(input, InputAction::MOVE_UP));
+  update_input(input, { evts + 1, 1 });
+  ASSERT_TRUE(action_pressed(input, InputAction::MOVE_UP));
+  shutdown_input(input);
+};
+
+TEST(Input, ReplayedDevicesAreTrackedWithoutOpening)
+{
+  static InputState input;
+  input.open_devices = false;
+  init_input(input);
+
+  SDL_Event added{};
+  added.type = SDL_EVENT_JOYSTICK_ADDED;
+  added.jdevice.which = 7;
+  SDL_Event gamepad{};
+  gamepad.type = SDL_EVENT_GAMEPAD_ADDED;
+  gamepad.gdevice.which = 7;
+  SDL_Event axis{};
+  axis.type = SDL_EVENT_GAMEPAD_AXIS_MOTION;
+  axis.gaxis.which = 7;
+  axis.gaxis.axis = SDL_GAMEPAD_AXIS_LEFTX;
+  axis.gaxis.value = 32767;
+  SDL_Event joystick_axis{}; // the same stick, from the joystick under the gamepad
+  joystick_axis.type = SDL_EVENT_JOYSTICK_AXIS_MOTION;
+  joystick_axis.jaxis.which = 7;
+  joystick_axis.jaxis.axis = SDL_GAMEPAD_AXIS_LEFTX;
+  joystick_axis.jaxis.value = -32768;
+  SDL_Event button{};
+  button.type = SDL_EVENT_GAMEPAD_BUTTON_DOWN;
+  button.gbutton.which = 7;
+  button.gbutton.button = SDL_GAMEPAD_BUTTON_SOUTH;
+  button.gbutton.down = true;
+
+  const SDL_Event evts[] = { added, gamepad, axis, joystick_axis, button };
+  update_input(input, evts);
+  ASSERT_EQ(1, input.n_devices);
+  ASSERT_EQ(nullptr, input.devices[0].gamepad);
+  ASSERT_FLOAT_EQ(1.0f, input_axis(input, InputAxis::MOVE_X));
+  ASSERT_TRUE(action_pressed(input, InputAction::PICKUP));
+
+  SDL_Event removed{};
+  removed.type = SDL_EVENT_JOYSTICK_REMOVED;
+  removed.jdevice.which = 7;
+  update_input(input, { &removed, 1 });
+  ASSERT_EQ(0, input.n_devices);
+  ASSERT_FLOAT_EQ(0.0f, input_axis(input, InputAxis::MOVE_X));
+  shutdown_input(input);
+};
@@ -0,0 +1,59 @@
+#include "core/pch.hpp"
+
+#include "core/latency/input_latency.hpp"
+
+#include <gtest/gtest.h>
+
+using namespace game2d;
+
+static InputLatencySample
+make_sample(const uint64_t event_ns, const uint64_t step_ns)
+{
+  InputLatencySample sample;
+  for (size_t i = 0; i < LATENCY_STAGE_COUNT; i++)
+    sample.ns[i] = event_ns + i * step_ns;
+  sample.valid = true;
+  return sample;
+};
+
+TEST(InputLatency, PercentilesAreNearestRank)
+{
+  std::array<float, 100> ms;
+  for (size_t i = 0; i < ms.size(); i++)
+    ms[i] = (float)(ms.size() - i); // 100 .. 1
+  const LatencyPercentiles p = compute_latency_percentiles(ms);
+  ASSERT_EQ(50.0f, p.p50_ms);
+  ASSERT_EQ(95.0f, p.p95_ms);
+  ASSERT_EQ(99.0f, p.p99_ms);
+  ASSERT_EQ(100.0f, p.max_ms);
+};
+
+TEST(InputLatency, StagesAreMeasuredFromThePreviousStage)
+{
+  static InputLatencyTracker tracker;
+  for (int i = 0; i < 10; i++)
+    record_latency_sample(tracker, make_sample(1000000 * (uint64_t)i, 2000000)); // 2ms per stage
+
+  const InputLatencyStats& stats = get_input_latency_stats(tracker);
+  ASSERT_EQ(10u, stats.n_samples);
+  ASSERT_FLOAT_EQ(2.0f, stats.stages[(size_t)LatencyStage::SIMULATE].p50_ms);
+  ASSERT_FLOAT_EQ(2.0f * (LATENCY_STAGE_COUNT - 1), stats.stages[(size_t)LatencyStage::EVENT].p99_ms);
+};
+
+TEST(InputLatency, OutOfOrderSamplesAreDropped)
+{
+  static InputLatencyTracker tracker;
+  InputLatencySample sample = make_sample(1000, 1000);
+  stamp_latency(sample, LatencyStage::POLL, 0); // never stamped
+  record_latency_sample(tracker, sample);
+  ASSERT_EQ(0u, get_input_latency_stats(tracker).n_total);
+};
+
+TEST(InputLatency, MergeKeepsTheOlderInput)
+{
+  InputLatencySample into = make_sample(5000, 10);
+  merge_latency_samples(into, make_sample(9000, 10));
+  ASSERT_EQ(5000u, into.ns[(size_t)LatencyStage::EVENT]);
+  merge_latency_samples(into, make_sample(1000, 10));
+  ASSERT_EQ(1000u, into.ns[(size_t)LatencyStage::EVENT]);
+};
@@ -0,0 +1,160 @@
+#include "core/pch.hpp"
+
+#include "core/common.hpp"
+#include "core/inventory/inventory_pool.hpp"
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+using namespace game2d;
+
+TEST(InventoryPool, ReleasedRangesAreSplitAndMerged)
+{
+  Registry r;
+  init_inventory_pool(r);
+  InventoryPool& pool = get_inventory_pool(r);
+
+  std::vector<entt::entity> batch(4);
+  r.create(batch.begin(), batch.end());
+  create_inventories(r, batch, 8, 0);
+  const entt::entity tail = r.create();
+  create_inventories(r, { &tail, 1 }, 8, 0);
+  ASSERT_EQ(40u, pool.slots.size());
+
+  // the batch's block is freed one inventory at a time, out of order
+  r.destroy(batch[1]);
+  r.destroy(batch[3]);
+  r.destroy(batch[0]);
+  r.destroy(batch[2]);
+  ASSERT_EQ(1u, pool.free.size());
+  ASSERT_EQ(32u, pool.free[0].capacity);
+
+  // smaller inventories fit in the merged range
+  std::vector<entt::entity> small(8);
+  r.create(small.begin(), small.end());
+  create_inventories(r, small, 4, 1);
+  ASSERT_EQ(40u, pool.slots.size());
+  ASSERT_TRUE(pool.free.empty());
+};
+
+TEST(InventoryPool, ChurnStaysBounded)
+{
+  Registry r;
+  init_inventory_pool(r);
+  InventoryPool& pool = get_inventory_pool(r);
+
+  // batches of different sizes and capacities, destroyed a round later
+  std::vector<entt::entity> previous;
+  std::vector<entt::entity> current;
+  size_t max_live = 0;
+  size_t max_slots = 0;
+  for (int round = 0; round < 500; round++) {
+    const size_t n = 1 + (size_t)((round * 37) % 64);
+    const uint16_t capacity = (round % 3 == 0) ? 4 : 8;
+    current.resize(n);
+    r.create(current.begin(), current.end());
+    create_inventories(r, current, capacity, 2);
+
+    size_t live = 0;
+    for (const auto& [e, inv] : r.view<const InventoryComponent>().each())
+      live += inv.capacity;
+    max_live = std::max(max_live, live);
+    max_slots = std::max(max_slots, pool.slots.size());
+
+    // every other one first, so the frees arrive out of order
+    for (size_t i = 0; i < previous.size(); i += 2)
+      r.destroy(previous[i]);
+    for (size_t i = 1; i < previous.size(); i += 2)
+      r.destroy(previous[i]);
+    previous.swap(current);
+  }
+  ASSERT_LE(max_slots, 2 * max_live);
+
+  for (const entt::entity e : previous)
+    r.destroy(e);
+  ASSERT_TRUE(pool.slots.empty());
+  ASSERT_TRUE(pool.free.empty());
+};
+
+TEST(InventoryPool, TransferIsClampedToCountAndSpace)
+{
+  Registry r;
+  init_inventory_pool(r);
+  InventoryPool& pool = get_inventory_pool(r);
+
+  // allocated back to back, so an overlap would show in a neighbour
+  std::vector<entt::entity> es(3);
+  r.create(es.begin(), es.end());
+  create_inventories(r, { &es[0], 1 }, 8, 5, 7);
+  create_inventories(r, { &es[1], 1 }, 4, 2, 3);
+  create_inventories(r, { &es[2], 1 }, 4, 4, 9);
+  auto& from = r.get<InventoryComponent>(es[0]);
+  auto& to = r.get<InventoryComponent>(es[1]);
+
+  // only 2 fit
+  ASSERT_EQ(2, transfer_items(pool, from, to, 10));
+  ASSERT_EQ(3, from.count);
+  ASSERT_EQ(4, to.count);
+  const auto items = get_items(pool, to);
+  ASSERT_EQ((std::vector<ItemId>{ 3, 3, 7, 7 }), std::vector<ItemId>(items.begin(), items.end()));
+
+  // the moved slots are cleared
+  for (uint32_t i = from.offset + from.count; i < from.offset + from.capacity; i++)
+    ASSERT_EQ(ITEM_NONE, pool.slots[i]);
+  for (const ItemId item : get_items(pool, r.get<const InventoryComponent>(es[2])))
+    ASSERT_EQ(9u, item);
+
+  // full, then only as many as there are
+  ASSERT_EQ(0, transfer_items(pool, from, to, 1));
+  to.count = 0;
+  ASSERT_EQ(3, transfer_items(pool, from, to, 10));
+  ASSERT_EQ(0, from.count);
+  ASSERT_EQ(0, transfer_items(pool, from, to, 1));
+};
+
+static void
+record_patch(std::vector<entt::entity>& patched, Registry& r, const entt::entity e)
+{
+  patched.push_back(e);
+};
+
+TEST(InventoryPool, TransfersAreAppliedInOrder)
+{
+  Registry r;
+  init_inventory_pool(r);
+
+  const entt::entity provider = r.create();
+  const entt::entity player = r.create();
+  const entt::entity receiver = r.create();
+  const entt::entity no_inventory = r.create();
+  const entt::entity destroyed = r.create();
+  r.destroy(destroyed);
+  create_inventories(r, { &provider, 1 }, 4, 4);
+  create_inventories(r, { &player, 1 }, 2, 0);
+  create_inventories(r, { &receiver, 1 }, 8, 0);
+
+  std::vector<entt::entity> patched;
+  r.on_update<InventoryComponent>().connect<&record_patch>(patched);
+
+  // the player passes on what it was given earlier in the same batch
+  std::vector<InventoryTransfer> transfers = {
+    { .from = provider, .to = player, .n = 3 },
+    { .from = player, .to = receiver, .n = 2 },
+    { .from = player, .to = player, .n = 1 },
+    { .from = destroyed, .to = receiver, .n = 1 },
+    { .from = no_inventory, .to = receiver, .n = 1 },
+  };
+  transfers[2].moved = 5; // cleared even when skipped
+  apply_inventory_transfers(r, transfers);
+
+  ASSERT_EQ(2, transfers[0].moved);
+  ASSERT_EQ(2, transfers[1].moved);
+  ASSERT_EQ(0, transfers[2].moved);
+  ASSERT_EQ(0, transfers[3].moved);
+  ASSERT_EQ(0, transfers[4].moved);
+  ASSERT_EQ(2, r.get<const InventoryComponent>(provider).count);
+  ASSERT_EQ(0, r.get<const InventoryComponent>(player).count);
+  ASSERT_EQ(2, r.get<const InventoryComponent>(receiver).count);
+  ASSERT_EQ((std::vector<entt::entity>{ provider, player, player, receiver }), patched);
+};
@@ -0,0 +1,106 @@
+#include "core/pch.hpp"
+
+#include "core/log/log.hpp"
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+using namespace game2d;
+
+template<typename... Args>
+static std::string
+format(const char* fmt, const Args&... args)
+{
+  const LogArg packed[sizeof...(Args) + 1] = { make_log_arg(args)..., LogArg{} };
+  std::string out;
+  format_log_args(out, fmt, packed, (int)sizeof...(Args));
+  return out;
+};
+
+static void
+capture_log(void* userdata, int, SDL_LogPriority, const char* message)
+{
+  static_cast<std::vector<std::string>*>(userdata)->push_back(message);
+};
+
+TEST(Log, FormatsLikePrintf)
+{
+  ASSERT_STREQ("a 1 -2 3 b", format("a %i %d %u b", 1, -2, 3u).c_str());
+  ASSERT_STREQ("0.50 x   7|", format("%0.2f %s %3zu|", 0.5f, "x", (size_t)7).c_str());
+  ASSERT_STREQ("100% ff 18446744073709551615", format("100%% %x %llu", 255, ~0ull).c_str());
+  ASSERT_STREQ("-1 4294967295", format("%i %u", -1, -1).c_str()); // cut to int, like printf
+  ASSERT_STREQ("str view", format("%s %s", std::string("str"), std::string_view("view")).c_str());
+  ASSERT_STREQ("1 (missing)", format("%i %i", 1).c_str());
+};
+
+TEST(Log, RecordsAreWrittenOnFlush)
+{
+  std::vector<std::string> lines;
+  SDL_SetLogOutputFunction(capture_log, &lines);
+
+  static Logger logger;
+  init_logger(logger);
+  set_logger(&logger);
+
+  const std::string name = "temporary";
+  LOG(INFO, GENERAL, "hello %s %i", name, 42);
+  ASSERT_TRUE(lines.empty()); // nothing formatted on the calling thread
+
+  flush_logger(logger);
+  set_logger(nullptr);
+  SDL_SetLogOutputFunction(nullptr, nullptr);
+
+  ASSERT_EQ(1u, lines.size());
+  ASSERT_TRUE(lines[0].ends_with("[info][general] hello temporary 42"));
+};
+
+TEST(Log, FullRingDropsRecords)
+{
+  std::vector<std::string> lines;
+  SDL_SetLogOutputFunction(capture_log, &lines);
+
+  static Logger logger;
+  init_logger(logger);
+  set_logger(&logger);
+
+  const int n = (int)(2 * LOG_RING_BYTES / 64);
+  for (int i = 0; i < n; i++)
+    LOG(WARN, GENERAL, "record %i", i);
+  flush_logger(logger);
+  set_logger(nullptr);
+  SDL_SetLogOutputFunction(nullptr, nullptr);
+
+  // what did fit is kept in order, then the drops are reported once
+  ASSERT_GT(lines.size(), 2u);
+  ASSERT_TRUE(lines[0].ends_with("record 0"));
+  ASSERT_TRUE(lines.back().starts_with("(Log) ring full"));
+};
+
+TEST(Log, WrapsWhenTheTailIsShorterThanAHeader)
+{
+  std::vector<std::string> lines;
+  SDL_SetLogOutputFunction(capture_log, &lines);
+
+  static Logger logger;
+  init_logger(logger);
+  set_logger(&logger);
+
+  // records without args are just the 24 byte header.
+  // fill the ring up to 16 bytes before the end
+  const int n_fill = (int)((LOG_RING_BYTES - 16) / 24);
+  for (int i = 0; i < n_fill; i++)
+    LOG(INFO, GENERAL, "fill");
+  flush_logger(logger);
+
+  // pads the 16 bytes, then wraps
+  LOG(INFO, GENERAL, "wrapped %i", 1);
+  flush_logger(logger);
+  set_logger(nullptr);
+  SDL_SetLogOutputFunction(nullptr, nullptr);
+
+  ASSERT_EQ((size_t)n_fill + 1, lines.size());
+  ASSERT_TRUE(lines[n_fill - 1].ends_with("fill"));
+  ASSERT_TRUE(lines.back().ends_with("wrapped 1"));
+};